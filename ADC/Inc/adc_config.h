@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    adc_config.h
+  * @author  Bartosz Rychlicki
+  * @Title   Universal driver for ADC peripheral
+  * @brief   This file contains compile-time configuration of ADC driver: buffer sizes and optional processing stages.
+  * 		 Macros guarded by #ifndef can be overridden by compiler definitions (-D) of project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 AGH Eko-Energy.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_ADC_CONFIG_H_
+#define INC_ADC_CONFIG_H_
+
+/* Exported Macros (Object Type)---------------------------------------------------------- */
+#define ADC_MAX_CHANNELS       16												// max length of regular sequence | number of ranks
+#define ADC_CHANNEL_IDS        19												// channel numbers 0 - 18, including internal channels
+#define ADC_AVERAGED_SHIFT     2												// averaged value is sum >> ADC_AVERAGED_SHIFT
+#define ADC_AVERAGED_MEASURES  (1U << ADC_AVERAGED_SHIFT)						// power of two, so averaging is a shift
+#define ADC_DMA_HALF_SCANS     ADC_AVERAGED_MEASURES							// scans of all ranks in one half of ping-pong buffer
+#ifndef ADC_SEQUENCE_LENGTH
+#define ADC_SEQUENCE_LENGTH    ADC_MAX_CHANNELS									// max ranks converted by application | sizes DMA buffer and per-rank state
+#endif
+#ifndef ADC_USE_MULTIMODE
+#define ADC_USE_MULTIMODE      1												// 0 - independent mode only, DMA buffer holds 16-bit samples
+#endif
+#ifndef ADC_USE_HW_OVERSAMPLING
+#define ADC_USE_HW_OVERSAMPLING 0												// 1 - averaging by hardware oversampler of G4/L4/H7, all stages then see averaged samples
+#endif
+#define ADC_HALF_BUFF_SIZE (ADC_SEQUENCE_LENGTH * ADC_DMA_HALF_SCANS)			// one half of ping-pong buffer | ADC_DMA_HALF_SCANS scans of all ranks
+#define ADC_BUFF_SIZE      (2 * ADC_HALF_BUFF_SIZE)							// whole circular DMA buffer  | two halves
+#define ADC_MAX_INSTANCES      3												// max number of driver contexts | ADC1, ADC2, ADC3
+#ifndef ADC_FIXED_Q
+#define ADC_FIXED_Q            16												// fractional bits of fixed-point values | Q16.16 by default
+#endif
+#ifndef ADC_USE_TIMER_TRIGGER
+#define ADC_USE_TIMER_TRIGGER  0												// 1 - acquisition triggered by timer TRGO at configured rate (needs HAL TIM module)
+#endif
+#ifndef ADC_USE_INJECTED
+#define ADC_USE_INJECTED       0												// 1 - injected group with external trigger, e.g. phase currents at PWM center
+#endif
+#define ADC_INJECTED_RANKS     4												// length of injected sequence | JDR1 - JDR4
+#define ADC_TO_FIXED(__VALUE__)   ((int32_t)((__VALUE__) * (float)(1UL << ADC_FIXED_Q)))	// constant to fixed-point, resolved at compile time for literals
+
+#ifndef ADC_USE_CALIBRATION
+#define ADC_USE_CALIBRATION    0												// 1 - offset, gain and piecewise-linear table of every channel in fixed-point path
+#endif
+#define ADC_CALIBRATION_GAIN_Q 16												// fractional bits of calibration gain
+
+/* Processing stages ---------------------------------------------------------------------- */
+#ifndef ADC_USE_SUBSCRIPTION
+#define ADC_USE_SUBSCRIPTION   0												// 1 - per-channel rate divider of stages, unsubscribed channels are computed on read
+#endif
+#ifndef ADC_USE_OVERSAMPLING
+#define ADC_USE_OVERSAMPLING   0												// 1 - software oversampling and decimation per channel
+#endif
+#define ADC_OVERSAMPLING_MAX_SHIFT 6											// max n of 4^n oversampling | 4096 samples, 6 extra bits
+#ifndef ADC_USE_EMA
+#define ADC_USE_EMA            0												// 1 - exponential moving average filter mode per channel
+#endif
+#define ADC_EMA_MAX_SHIFT      15												// max k of EMA | time constant of 2^k samples, accumulator fits 32 bits
+#ifndef ADC_USE_MEDIAN
+#define ADC_USE_MEDIAN         0												// 1 - median / trimmed mean prefilter rejecting single-sample spikes
+#endif
+#define ADC_MEDIAN_MAX_SIZE    9												// max window of median prefilter | 3, 5, 7 or 9 samples
+#ifndef ADC_USE_STATS
+#define ADC_USE_STATS          0												// 1 - min, max, mean and peak-to-peak of every channel over window
+#endif
+#define ADC_STATS_MAX_WINDOW   65536UL											// max window of statistics in samples | sum of window fits 32 bits
+#ifndef ADC_USE_POWER
+#define ADC_USE_POWER          0												// 1 - RMS and active power of voltage / current channel pairs
+#endif
+#define ADC_POWER_MAX_PAIRS    3												// max number of channel pairs | e.g. three motor phases
+#ifndef ADC_USE_GOERTZEL
+#define ADC_USE_GOERTZEL       0												// 1 - Goertzel bins measuring amplitude of selected frequencies
+#endif
+#define ADC_GOERTZEL_MAX_BINS  4												// max number of bins of one ADC | any channel, several bins per channel
+#define ADC_GOERTZEL_COEFF_Q   29												// fractional bits of Goertzel coefficient 2cos(w)
+#ifndef ADC_USE_WATCHDOG
+#define ADC_USE_WATCHDOG       0												// 1 - software analog watchdog of every channel, checked in DMA callbacks
+#endif
+#ifndef ADC_USE_CAPTURE
+#define ADC_USE_CAPTURE        0												// 1 - timestamped capture ring of selected channels with trigger
+#endif
+#ifndef ADC_CAPTURE_DEPTH
+#define ADC_CAPTURE_DEPTH      64												// entries of capture ring | one decimated scan per entry
+#endif
+#define ADC_CAPTURE_CHANNELS   4												// max channels recorded in one entry
+#ifndef ADC_CAPTURE_TIMESTAMP
+#define ADC_CAPTURE_TIMESTAMP() HAL_GetTick()									// timestamp of entries, e.g. DWT->CYCCNT for CPU cycles (DWT enabled by application)
+#endif
+#ifndef ADC_CAPTURE_TIMESTAMP_HZ
+#define ADC_CAPTURE_TIMESTAMP_HZ 1000U											// ticks per second of ADC_CAPTURE_TIMESTAMP, e.g. SystemCoreClock for DWT->CYCCNT
+#endif
+#ifndef ADC_USE_NOTCH
+#define ADC_USE_NOTCH          0												// 1 - notch filter mode rejecting ripple frequency and its harmonics
+#endif
+#define ADC_NOTCH_MAX_HARMONICS 3												// max number of notched harmonics | one biquad section per harmonic
+#ifndef ADC_NOTCH_BANDWIDTH
+#define ADC_NOTCH_BANDWIDTH    4.0f												// -3 dB width of every notch in Hz
+#endif
+#define ADC_NOTCH_COEFF_Q      29												// fractional bits of notch coefficients, range of +-4 covers |a1|, |b1| <= 2
+#define ADC_NOTCH_STATE_Q      8												// fractional bits of notch states, limits rounding noise near poles
+
+#endif /* INC_ADC_CONFIG_H_ */
@@ -28,25 +28,20 @@ extern "C" {
 /* Includes ----------------------------------------------------------------------------*/
 #include "main.h"
 #include "stm32_family.h"
+#include "adc_config.h"
+#include "adc_filters.h"
 //#include "stm32f105xc.h"
 
-/* Exported Macros (Object Type)---------------------------------------------------------- */
-#define ADC_MAX_CHANNELS       16
-#define ADC_AVERAGED_MEASURES  5
-#define ADC_BUFF_SIZE (ADC_MAX_CHANNELS * ADC_AVERAGED_MEASURES)
-
-/* Exported Private Variables---------------------------------------------------------- */
-extern 			ADC_HandleTypeDef   hadc1;
-static volatile int                 ADC_CONVERTED_CHANNELS = 1;
-
 /* Private Typedefs ------------------------------------------------------------------- */
 /**
   * @brief  DMA buffer typedef for ADCs in multimode
+  * 		Packed words are split once per completed half: master measures into master context, slave measures into slave context
   */
 typedef union{
-		uint32_t BufferMultiMode[ADC_BUFF_SIZE];
-		uint16_t BufferADC_Master[ADC_BUFF_SIZE];
-		uint16_t BufferADC_Slave[ADC_BUFF_SIZE];
+
+	uint32_t BufferMultiMode[ADC_BUFF_SIZE];		// dma buffer | master in bits 15:0, slave in bits 31:16
+
+	uint16_t BufferInterleaved[2 * ADC_BUFF_SIZE];	// the same buffer in interleaved mode | samples of one channel in time order
 
 }DMA_DualmodeBufferTypeDef;
 
@@ -58,27 +53,242 @@ typedef union{
 
 }DMA_IndependentModeBufferTypeDef;
 
+/**
+  * @brief  DMA ping-pong state | tells readers whether any half was completed and whether DMA completed another one meanwhile
+  * 		Completed half itself is processed in DMA callback, readers see its results, not the buffer
+  */
 typedef struct{
 
+	volatile uint8_t  isReady;							// set after first completed half, before that no data is valid
+
+	volatile uint32_t sequence;							// incremented on every completed half | lets readers detect that DMA overtook them
+
+}ADC_PingPongTypeDef;
+
+/**
+  * @brief  ADC buffer typedef | DMA buffer of ADC owning DMA, declared by application next to context and given to ADC_Init
+  * 		Layouts of all acquisition modes share one storage, because only one mode is active. Slave and polling ADCs need none
+  */
+typedef union{
+
+#if ADC_USE_MULTIMODE
 	DMA_DualmodeBufferTypeDef 		 ddma;				// dma buffer for dualmode
+#endif
 
 	DMA_IndependentModeBufferTypeDef idma;				// dma buffer for independent mode
 
-	uint32_t ADC_Buff[ADC_BUFF_SIZE];								// adc buff for all channels, in situation ADC is single shot mode
-
 }ADC_BufferTypeDef;
 
 
+/**
+  * @brief  Running-sum averaging state | updated once per sample in DMA callbacks, read in constant time
+  */
+typedef struct{
+
+	uint16_t 		  ring[ADC_SEQUENCE_LENGTH][ADC_AVERAGED_MEASURES];	// latest ADC_AVERAGED_MEASURES measures of every rank
+
+	volatile uint32_t sum[ADC_SEQUENCE_LENGTH];							// running sum of ring of every rank
+
+	uint8_t  		  position;											// ring position to be overwritten, common for all ranks
+
+	volatile uint8_t  filled;											// number of valid measures in ring, averages are valid when ring is full
+
+}ADC_AveragingTypeDef;
+
+
 /**
   * @brief  ADC's channels' ranks definotion
   */
 typedef struct{
 
-	uint8_t channels[ADC_MAX_CHANNELS];						// Channels for all ranks | auto detect
+	uint8_t  channels[ADC_MAX_CHANNELS];						// Channels for all ranks | auto detect
+
+	uint8_t  rankOfChannel[ADC_CHANNEL_IDS];					// Inverse table: rank of every channel | valid only for channels in mask
+
+	uint32_t mask;												// Bitmask of configured channels, bit n set - channel n is converted
 
 }ADC_ChannelsTypeDef;
 
 
+/**
+  * @brief  ADC acquisition modes definition
+  */
+typedef enum{
+	ADC_MODE_POLLING = 0,										// DMA disabled, values are read by software
+	ADC_MODE_INDEPENDENT,										// DMA enabled, ADC in independent mode
+	ADC_MODE_MULTIMODE,											// DMA enabled, ADC in dual mode
+	ADC_MODE_INTERLEAVED										// DMA enabled, 2 or 3 ADCs interleaved on one channel
+
+}ADC_AcquisitionModeTypeDef;
+
+
+/**
+  * @brief  ADC configuration snapshot | taken at ADC_Init and ADC_Reconfigure, read paths never access peripheral registers
+  */
+typedef struct{
+
+	ADC_AcquisitionModeTypeDef mode;							// resolved acquisition mode
+
+	uint16_t 				   resolution;						// max converted value
+
+	uint8_t 				   resolutionBits;					// number of bits of converted value
+
+	uint8_t 				   convertedChannels;				// number of ranks in regular sequence
+
+	uint8_t 				   dmaCircular;						// 1 - DMA in circular mode, 0 - DMA stops after whole buffer
+
+	uint8_t 				   interleaved;						// number of ADCs interleaved on one channel, 0 - not interleaved
+
+	uint8_t 				   hwOversampling;					// 1 - samples are averaged by hardware oversampler, running sums keep newest sample
+
+	float 					   sampleRate;						// sample rate of every channel in Hz, 0 - unknown (continuous mode) | kept by snapshot
+
+	uint32_t 				   samplePeriod;					// sample period of every channel in timer clocks, 0 - unknown
+
+	uint32_t 				   timerClock;						// clock of trigger timer in Hz
+
+}ADC_ConfigTypeDef;
+
+
+#if ADC_USE_CALIBRATION
+/**
+  * @brief  ADC piecewise-linear calibration table | values at uniform raw steps of 2^stepShift LSB, in fixed-point format
+  * 		Defined at compile time by ADC_CALIBRATION_TABLE, e.g. from NTC datasheet
+  */
+typedef struct{
+
+	const int32_t* points;										// values at raw 0, 2^stepShift, 2 * 2^stepShift ...
+
+	uint16_t 	   count;										// number of points, raw above last point returns last value
+
+	uint8_t 	   stepShift;									// raw step between points is 2^stepShift
+
+}ADC_CalibrationTableTypeDef;
+#endif
+
+
+/**
+  * @brief  ADC fixed-point scaling of rank | value = raw * scale >> resolutionBits, no division nor float on read
+  */
+typedef struct{
+
+	int32_t max;												// value of full scale in fixed-point format
+
+	int32_t scale;												// precomputed (max << resolutionBits) / resolution
+
+#if ADC_USE_CALIBRATION
+	int32_t offset;												// raw offset in LSB, subtracted before gain
+
+	int32_t gain;												// raw gain | Q ADC_CALIBRATION_GAIN_Q
+
+	const ADC_CalibrationTableTypeDef* table;					// table replacing linear scale, NULL if none
+#endif
+
+}ADC_FixedScaleTypeDef;
+
+
+/**
+  * @brief  ADC driver context | every ADC instance owns its own context, so instances do not share any state
+  * 		In dual mode slave context has no DMA buffer, master's DMA callbacks split its measures into slave's block
+  */
+struct __ADC_ContextTypeDef;
+
+#if ADC_USE_WATCHDOG
+/**
+  * @brief  ADC watchdog callback | called from DMA callback when state of channel changes
+  */
+typedef void (*ADC_WatchdogCallbackTypeDef)(struct __ADC_ContextTypeDef* ctx, uint8_t channel, ADC_WatchdogStateTypeDef state, uint16_t value);
+#endif
+
+#if ADC_USE_INJECTED
+/**
+  * @brief  ADC injected callback | called from ADC interrupt at end of injected sequence, JDRx hold new values
+  */
+typedef void (*ADC_InjectedCallbackTypeDef)(struct __ADC_ContextTypeDef* ctx);
+
+
+/**
+  * @brief  ADC injected group | converted on external trigger, interrupting regular DMA scan
+  */
+typedef struct{
+
+	uint8_t 					channels[ADC_INJECTED_RANKS];	// channels of injected ranks
+
+	uint8_t 					count;							// length of injected sequence, 0 - group not configured
+
+	volatile uint32_t 			sequence;						// number of completed injected sequences
+
+	ADC_InjectedCallbackTypeDef callback;						// application callback, NULL if none
+
+}ADC_InjectedTypeDef;
+#endif
+
+
+typedef struct __ADC_ContextTypeDef{
+
+	ADC_HandleTypeDef* 			 hadc;							// handle of ADC served by context
+
+	ADC_ConfigTypeDef 			 config;						// configuration snapshot
+
+	ADC_ChannelsTypeDef 		 cadc;							// ranks of channels
+
+	ADC_BufferTypeDef* 			 badc;							// DMA buffer, owned by application | NULL for slave and in polling mode
+
+	ADC_PingPongTypeDef 		 pp;							// ping-pong state of DMA buffer
+
+#if ADC_USE_MULTIMODE
+	uint16_t 					 block[ADC_HALF_BUFF_SIZE];		// dual mode: own measures of last completed half, split from packed words
+#endif
+
+	ADC_AveragingTypeDef 		 aadc;							// running sums
+
+	ADC_FixedScaleTypeDef 		 fixed[ADC_SEQUENCE_LENGTH];	// fixed-point scaling of every rank
+
+	ADC_FiltersTypeDef 			 filters;						// optional processing stages of every rank
+
+#if ADC_USE_SUBSCRIPTION
+	const uint16_t* volatile 	 lastBlock;						// last completed block of measures, lazy ranks are computed from it
+
+	volatile uint32_t 			 lastScans;						// number of scans in last completed block
+#endif
+
+#if ADC_USE_WATCHDOG
+	ADC_WatchdogCallbackTypeDef  watchdogCallback;				// application callback of watchdog events, NULL if none
+#endif
+
+#if ADC_USE_INJECTED
+	ADC_InjectedTypeDef 		 injected;						// injected group
+#endif
+
+	struct __ADC_ContextTypeDef* slave;							// dual mode: context of slave ADC, NULL if none
+
+	struct __ADC_ContextTypeDef* master;						// dual mode: context of master ADC, which owns DMA | NULL for master
+
+}ADC_ContextTypeDef;
+
+
+/**
+  * @brief  ADC RAM footprint report | sizes in bytes, resolved at compile time
+  */
+typedef struct{
+
+	uint32_t sequenceLength;									// ADC_SEQUENCE_LENGTH, which sizes buffer and per-rank state
+
+	uint32_t buffer;											// DMA buffer with overlaid layouts, declared only for ADC owning DMA
+
+	uint32_t separateBuffers;									// DMA buffer if layouts of all modes were reserved side by side
+
+	uint32_t block;												// dual-mode measures of one half split into every context, slave's only sample storage
+
+	uint32_t averaging;											// running sums
+
+	uint32_t context;											// whole context of one ADC instance, all a slave or polling ADC needs
+
+}ADC_FootprintTypeDef;
+
+extern const ADC_FootprintTypeDef ADC_Footprint;
+
+
 /**
   * @brief  ADC Status structures definition
   */
@@ -95,12 +305,33 @@ typedef enum{
 }ADC_StatusTypeDef;
 
 
+#if ADC_USE_CALIBRATION
+/* Exported Macros (Function type)------------------------------------------------------------------- */
+/**
+  * @brief  Calibration table definition | const points in flash, e.g. ADC_CALIBRATION_TABLE(ntc, 8, ADC_TO_FIXED(150.0), ADC_TO_FIXED(98.5), ...)
+  */
+#define ADC_CALIBRATION_TABLE(__NAME__, __STEP_SHIFT__, ...)																\
+	static const int32_t __NAME__##_points[] = { __VA_ARGS__ };																\
+	static const ADC_CalibrationTableTypeDef __NAME__ = { __NAME__##_points, (uint16_t)(sizeof(__NAME__##_points) / sizeof(int32_t)), (__STEP_SHIFT__) }
+#endif
+
+
 /* Private Macros (Function type)------------------------------------------------------------------- */
 #if defined(STM32F1_FAMILY)
 
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											(((((__HANDLE__)->Instance->CR1 >> ADC_CR1_DUALMOD_Pos) & 0xFU) == 0x7U || 		\
+											  (((__HANDLE__)->Instance->CR1 >> ADC_CR1_DUALMOD_Pos) & 0xFU) == 0x8U) ? 2U : 0U)		// fast or slow interleaved
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(1U)									// slave (bits 31:16) converts before master
+
 	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
 											((((((__HANDLE__)->Instance->CR1      >> ADC_CR1_DUALMOD_Pos) & 0xF) == 0U) ? 0U : 1U))
 
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											(1U)									// ADC2 data is always in bits 31:16 of ADC1 DR
+
 	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
 											(((((__HANDLE__)->Instance->SR)       >> ADC_SR_STRT_Pos ) & 0x1U))
 
@@ -119,10 +350,53 @@ typedef enum{
 	#define __ADC_MODE(__HANDLE__)                                                          												\
 											((((__HANDLE__)->Instance->CR2         >> ADC_CR2_CONT_Pos) & 0x1U))
 
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_ADCEx_Calibration_Start(__HANDLE__))
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 6U)  ? ((__HANDLE__)->Instance->SQR3 >> (5U * (__RANK__)))         : 		\
+											  ((__RANK__) < 12U) ? ((__HANDLE__)->Instance->SQR2 >> (5U * ((__RANK__) - 6U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR1 >> (5U * ((__RANK__) - 12U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CR2, ADC_CR2_EXTSEL | ADC_CR2_EXTTRIG | ADC_CR2_CONT, 		\
+											            (__TRIGGER__) | ADC_CR2_EXTTRIG))
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((void)(__CONFIG__))					// trigger edge is fixed in this family
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(ADC_INJECTED_RANK_1 + (__N__))					// HAL ranks are consecutive numbers
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											((uint32_t)(__ID__))						// HAL channel is its number
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											((void)(__HANDLE__))					// no hardware oversampler in this family
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											(0U)
+
 #elif defined(STM32F2_FAMILY)
 
-	#define __ADC_IS_DMA_MULTIMODE                                                          												\
-											((READ_REG(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == ADC_CCR_MULTI_0) ? 0U : 1U)
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0x07U) ? 2U : 						\
+											 (READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0x17U) ? 3U : 0U)		// dual or triple interleaved
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(0U)									// DMA mode 2, halfwords are in order ADC1, ADC2 (, ADC3)
+
+	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0U) ? 0U : 1U)
+
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_DMA) == ADC_CCR_DMA_1) ? 1U : 0U)			// DMA mode 2, two halfwords per request
 
 	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
 											(((((__HANDLE__)->Instance->SR) >> ADC_SR_STRT_Pos) & 0x1U))
@@ -144,10 +418,52 @@ typedef enum{
 	#define __ADC_MODE(__HANDLE__)                                                          												\
 											((((__HANDLE__)->Instance->CR2 >> ADC_CR2_CONT_Pos) & 0x1U))
 
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_OK)								// no self-calibration in this family
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 6U)  ? ((__HANDLE__)->Instance->SQR3 >> (5U * (__RANK__)))         : 		\
+											  ((__RANK__) < 12U) ? ((__HANDLE__)->Instance->SQR2 >> (5U * ((__RANK__) - 6U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR1 >> (5U * ((__RANK__) - 12U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CR2, ADC_CR2_EXTSEL | ADC_CR2_EXTEN | ADC_CR2_CONT, 		\
+											            (__TRIGGER__) | ADC_CR2_EXTEN_0))		// rising edge
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((__CONFIG__)->ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING)
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(ADC_INJECTED_RANK_1 + (__N__))					// HAL ranks are consecutive numbers
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											((uint32_t)(__ID__))						// HAL channel is its number
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											((void)(__HANDLE__))					// no hardware oversampler in this family
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											(0U)
+
 #elif defined(STM32F3_FAMILY)
 
-	#define __ADC_IS_DMA_MULTIMODE                                                          												\
-											((READ_REG(ADC_COMMON->CCR, ADC12_CCR_MULTI_Msk) == 0U) ? 0U : 1U)
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											((READ_BIT(ADC_COMMON->CCR, ADC12_CCR_MULTI_Msk) == 0x07U) ? 2U : 0U)
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(0U)									// master (bits 15:0) converts first
+
+	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
+											((READ_BIT(ADC_COMMON->CCR, ADC12_CCR_MULTI_Msk) == 0U) ? 0U : 1U)
+
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											((READ_BIT(ADC_COMMON->CCR, ADC12_CCR_MDMA) == ADC12_CCR_MDMA_1) ? 1U : 0U)		// MDMA for 12 and 10-bit resolution
 
 	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
 											(((((__HANDLE__)->Instance->CR >> ADC_CR_ADSTART_Pos) & 0x1U)))
@@ -169,10 +485,57 @@ typedef enum{
 	#define __ADC_MODE(__HANDLE__)                                                          												\
 											((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_CONT_Pos) & 0x1U))
 
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_ADCEx_Calibration_Start((__HANDLE__), ADC_SINGLE_ENDED))
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 4U)  ? ((__HANDLE__)->Instance->SQR1 >> (6U * ((__RANK__) + 1U)))  : 		\
+											  ((__RANK__) < 9U)  ? ((__HANDLE__)->Instance->SQR2 >> (6U * ((__RANK__) - 4U)))  : 		\
+											  ((__RANK__) < 14U) ? ((__HANDLE__)->Instance->SQR3 >> (6U * ((__RANK__) - 9U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR4 >> (6U * ((__RANK__) - 14U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CFGR, ADC_CFGR_EXTSEL | ADC_CFGR_EXTEN | ADC_CFGR_CONT, 	\
+											            (__TRIGGER__) | ADC_CFGR_EXTEN_0))		// rising edge, ADSTART must be 0
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((__CONFIG__)->ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING, 				\
+											 (__CONFIG__)->InjectedSingleDiff        = ADC_SINGLE_ENDED, 								\
+											 (__CONFIG__)->InjectedOffsetNumber      = ADC_OFFSET_NONE, 								\
+											 (__CONFIG__)->QueueInjectedContext      = DISABLE)
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(ADC_INJECTED_RANK_1 + (__N__))					// HAL ranks are consecutive numbers
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											((uint32_t)(__ID__))						// HAL channel is its number
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											((void)(__HANDLE__))					// no hardware oversampler in this family
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											(0U)
+
 #elif defined(STM32F4_FAMILY)
 
-	#define __ADC_IS_DMA_MULTIMODE                                                          												\
-											((READ_REG(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == ADC_CCR_MULTI_0) ? 0U : 1U)
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0x07U) ? 2U : 						\
+											 (READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0x17U) ? 3U : 0U)		// dual or triple interleaved
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(0U)									// DMA mode 2, halfwords are in order ADC1, ADC2 (, ADC3)
+
+	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_MULTI_Msk) == 0U) ? 0U : 1U)
+
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											((READ_BIT(ADC_COMMON->CCR, ADC_CCR_DMA) == ADC_CCR_DMA_1) ? 1U : 0U)			// DMA mode 2, two halfwords per request
 
 	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
 											(((((__HANDLE__)->Instance->SR) >> ADC_SR_STRT_Pos) & 0x1U))
@@ -194,24 +557,315 @@ typedef enum{
 	#define __ADC_MODE(__HANDLE__)                                                          												\
 											((((__HANDLE__)->Instance->CR2 >> ADC_CR2_CONT_Pos) & 0x1U))
 
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_OK)								// no self-calibration in this family
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 6U)  ? ((__HANDLE__)->Instance->SQR3 >> (5U * (__RANK__)))         : 		\
+											  ((__RANK__) < 12U) ? ((__HANDLE__)->Instance->SQR2 >> (5U * ((__RANK__) - 6U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR1 >> (5U * ((__RANK__) - 12U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CR2, ADC_CR2_EXTSEL | ADC_CR2_EXTEN | ADC_CR2_CONT, 		\
+											            (__TRIGGER__) | ADC_CR2_EXTEN_0))		// rising edge
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((__CONFIG__)->ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING)
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(ADC_INJECTED_RANK_1 + (__N__))					// HAL ranks are consecutive numbers
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											((uint32_t)(__ID__))						// HAL channel is its number
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											((void)(__HANDLE__))					// no hardware oversampler in this family
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											(0U)
+
+#elif defined(STM32G4_FAMILY) || defined(STM32L4_FAMILY)
+
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_DUAL) == 0x07U) ? 2U : 0U)
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(0U)									// master (bits 15:0) converts first
+
+	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_DUAL) == 0U) ? 0U : 1U)
+
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_MDMA) == ADC_CCR_MDMA_1) ? 1U : 0U)	// MDMA for 12 and 10-bit resolution
+
+	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
+											(((((__HANDLE__)->Instance->CR >> ADC_CR_ADSTART_Pos) & 0x1U)))
+
+	#define __ADC_IS_DMA_ENABLED(__HANDLE__)                                                												\
+											((READ_BIT((__HANDLE__)->Instance->CFGR, ADC_CFGR_DMAEN)))
+
+	#define __ADC_RESOLUTION(__HANDLE__)                                                    												\
+											(((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_RES_Pos) & 0b11) == 0b00) ? 4095U : 			\
+											 ((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_RES_Pos) & 0b11) == 0b01) ? 1023U : 			\
+											 ((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_RES_Pos) & 0b11) == 0b10) ? 255U  : 63U )
+
+	#define __ADC_DMA_MODE(__HANDLE__)                                                      												\
+											(((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_DMACFG_Pos) & 0x1U)))
+
+	#define __ADC_EOC(__HANDLE__)                                                           												\
+											((((__HANDLE__)->Instance->ISR >> ADC_ISR_EOC_Pos) & 0x1U))
+
+	#define __ADC_MODE(__HANDLE__)                                                          												\
+											((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_CONT_Pos) & 0x1U))
+
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_ADCEx_Calibration_Start((__HANDLE__), ADC_SINGLE_ENDED))
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 4U)  ? ((__HANDLE__)->Instance->SQR1 >> (6U * ((__RANK__) + 1U)))  : 		\
+											  ((__RANK__) < 9U)  ? ((__HANDLE__)->Instance->SQR2 >> (6U * ((__RANK__) - 4U)))  : 		\
+											  ((__RANK__) < 14U) ? ((__HANDLE__)->Instance->SQR3 >> (6U * ((__RANK__) - 9U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR4 >> (6U * ((__RANK__) - 14U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CFGR, ADC_CFGR_EXTSEL | ADC_CFGR_EXTEN | ADC_CFGR_CONT, 	\
+											            (__TRIGGER__) | ADC_CFGR_EXTEN_0))		// rising edge, ADSTART must be 0
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((__CONFIG__)->ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING, 				\
+											 (__CONFIG__)->InjectedSingleDiff        = ADC_SINGLE_ENDED, 								\
+											 (__CONFIG__)->InjectedOffsetNumber      = ADC_OFFSET_NONE, 								\
+											 (__CONFIG__)->QueueInjectedContext      = DISABLE)
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(((__N__) == 0U) ? ADC_INJECTED_RANK_1 : ((__N__) == 1U) ? ADC_INJECTED_RANK_2 : 					\
+											 ((__N__) == 2U) ? ADC_INJECTED_RANK_3 : ADC_INJECTED_RANK_4)		// HAL ranks are encoded JSQR positions
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											(__LL_ADC_DECIMAL_NB_TO_CHANNEL(__ID__))				// HAL channel encodes number, bitfield and sampling time position
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											(MODIFY_REG((__HANDLE__)->Instance->CFGR2, ADC_CFGR2_ROVSE | ADC_CFGR2_OVSR | ADC_CFGR2_OVSS, 			\
+											            ADC_CFGR2_ROVSE | 																\
+											            (((uint32_t)(__SHIFT__) - 1U) << ADC_CFGR2_OVSR_Pos) | ((uint32_t)(__SHIFT__) << ADC_CFGR2_OVSS_Pos)))	// ratio 2^(OVSR + 1), TROVS and ROVSM kept, ADSTART must be 0
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											((READ_BIT((__HANDLE__)->Instance->CFGR2, ADC_CFGR2_ROVSE) == 0U) ? 0U : 1U)
+
+#elif defined(STM32H7_FAMILY)
+
+	#define __ADC_INTERLEAVED(__HANDLE__)                                                   												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_DUAL) == 0x07U) ? 2U : 0U)
+
+	#define __ADC_INTERLEAVED_HIGH_FIRST                                                    												\
+											(0U)									// master (bits 15:0) converts first
+
+	#define __ADC_IS_DMA_MULTIMODE(__HANDLE__)                                              												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_DUAL) == 0U) ? 0U : 1U)
+
+	#define __ADC_IS_DMA_PACKED(__HANDLE__)                                                 												\
+											((READ_BIT(__LL_ADC_COMMON_INSTANCE((__HANDLE__)->Instance)->CCR, ADC_CCR_DAMDF) == ADC_CCR_DAMDF_1) ? 1U : 0U)	// DAMDF for 32 down to 10-bit resolution
+
+	#define __ADC_IS_CONV_STARTED(__HANDLE__)                                               												\
+											(((((__HANDLE__)->Instance->CR >> ADC_CR_ADSTART_Pos) & 0x1U)))
+
+	#define __ADC_IS_DMA_ENABLED(__HANDLE__)                                                												\
+											((READ_BIT((__HANDLE__)->Instance->CFGR, ADC_CFGR_DMNGT_0)))			// DMNGT 01 - one shot, 11 - circular
+
+	#define __ADC_RESOLUTION(__HANDLE__)                                                    												\
+											(((__HANDLE__)->Init.Resolution == ADC_RESOLUTION_16B) ? 65535U : 						\
+											 ((__HANDLE__)->Init.Resolution == ADC_RESOLUTION_14B) ? 16383U : 						\
+											 ((__HANDLE__)->Init.Resolution == ADC_RESOLUTION_12B) ? 4095U  : 						\
+											 ((__HANDLE__)->Init.Resolution == ADC_RESOLUTION_10B) ? 1023U  : 255U )			// RES encoding differs between silicon revisions
+
+	#define __ADC_DMA_MODE(__HANDLE__)                                                      												\
+											((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_DMNGT_Pos) & 0x3U) == 0x3U)
+
+	#define __ADC_EOC(__HANDLE__)                                                           												\
+											((((__HANDLE__)->Instance->ISR >> ADC_ISR_EOC_Pos) & 0x1U))
+
+	#define __ADC_MODE(__HANDLE__)                                                          												\
+											((((__HANDLE__)->Instance->CFGR >> ADC_CFGR_CONT_Pos) & 0x1U))
+
+	#define __ADC_CALIBRATE(__HANDLE__)                                                     												\
+											(HAL_ADCEx_Calibration_Start((__HANDLE__), ADC_CALIB_OFFSET, ADC_SINGLE_ENDED))
+
+	#define __ADC_SEQUENCE_LENGTH(__HANDLE__)                                               												\
+											((((__HANDLE__)->Instance->SQR1 >> ADC_SQR1_L_Pos) & 0xFU) + 1U)
+
+	#define __ADC_SEQUENCE_CHANNEL(__HANDLE__, __RANK__)                                    												\
+											(((((__RANK__) < 4U)  ? ((__HANDLE__)->Instance->SQR1 >> (6U * ((__RANK__) + 1U)))  : 		\
+											  ((__RANK__) < 9U)  ? ((__HANDLE__)->Instance->SQR2 >> (6U * ((__RANK__) - 4U)))  : 		\
+											  ((__RANK__) < 14U) ? ((__HANDLE__)->Instance->SQR3 >> (6U * ((__RANK__) - 9U)))  : 		\
+											                       ((__HANDLE__)->Instance->SQR4 >> (6U * ((__RANK__) - 14U)))) & 0x1FU))
+
+	#define __ADC_SET_EXTERNAL_TRIGGER(__HANDLE__, __TRIGGER__)                             												\
+											(MODIFY_REG((__HANDLE__)->Instance->CFGR, ADC_CFGR_EXTSEL | ADC_CFGR_EXTEN | ADC_CFGR_CONT, 	\
+											            (__TRIGGER__) | ADC_CFGR_EXTEN_0))		// rising edge, ADSTART must be 0
+
+	#define __ADC_INJECTED_DATA(__HANDLE__, __RANK__)                                       												\
+											(((&(__HANDLE__)->Instance->JDR1)[(__RANK__)]) & 0xFFFFU)			// JDR1 - JDR4 are consecutive
+
+	#define __ADC_INJECTED_CONFIG_FAMILY(__CONFIG__)                                        												\
+											((__CONFIG__)->ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING, 				\
+											 (__CONFIG__)->InjectedSingleDiff        = ADC_SINGLE_ENDED, 								\
+											 (__CONFIG__)->InjectedOffsetNumber      = ADC_OFFSET_NONE, 								\
+											 (__CONFIG__)->QueueInjectedContext      = DISABLE)
+
+	#define __ADC_INJECTED_RANK(__N__)                                                      												\
+											(((__N__) == 0U) ? ADC_INJECTED_RANK_1 : ((__N__) == 1U) ? ADC_INJECTED_RANK_2 : 					\
+											 ((__N__) == 2U) ? ADC_INJECTED_RANK_3 : ADC_INJECTED_RANK_4)		// HAL ranks are encoded JSQR positions
+
+	#define __ADC_CHANNEL_FROM_ID(__ID__)                                                   												\
+											(__LL_ADC_DECIMAL_NB_TO_CHANNEL(__ID__))				// HAL channel encodes number, bitfield and sampling time position
+
+	#define __ADC_SET_HW_OVERSAMPLING(__HANDLE__, __SHIFT__)                                												\
+											(MODIFY_REG((__HANDLE__)->Instance->CFGR2, ADC_CFGR2_ROVSE | ADC_CFGR2_OVSR | ADC_CFGR2_OVSS, 			\
+											            ADC_CFGR2_ROVSE | 																\
+											            (((1UL << (__SHIFT__)) - 1U) << ADC_CFGR2_OVSR_Pos) | ((uint32_t)(__SHIFT__) << ADC_CFGR2_OVSS_Pos)))	// ratio OVSR + 1, TROVS and ROVSM kept, ADSTART must be 0
+
+	#define __ADC_IS_HW_OVERSAMPLING(__HANDLE__)                                            												\
+											((READ_BIT((__HANDLE__)->Instance->CFGR2, ADC_CFGR2_ROVSE) == 0U) ? 0U : 1U)
+
 
 #endif
 
 
 /* Private functions Prototypes -------------------------------------------------------  */
-HAL_StatusTypeDef        ADC_Init(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef        ADC_Init(ADC_ContextTypeDef* ctx, ADC_HandleTypeDef* hadc, ADC_BufferTypeDef* buffer);
+
+HAL_StatusTypeDef        ADC_InitSlave(ADC_ContextTypeDef* ctx, ADC_HandleTypeDef* hadc, ADC_ContextTypeDef* master);
+
+HAL_StatusTypeDef        ADC_Reconfigure(ADC_ContextTypeDef* ctx);
+
+ADC_ContextTypeDef*      ADC_GetContext(ADC_HandleTypeDef* hadc);
+
+ADC_StatusTypeDef        ADC_ReadChannel(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t*  retval);
+
+__weak ADC_StatusTypeDef ADC_GetValue(ADC_ContextTypeDef* ctx, float max, uint8_t channel, float * retval);
+
+ADC_StatusTypeDef        ADC_ReadAllChannels(ADC_ContextTypeDef* ctx, uint16_t* raw, float* scaled, float max, uint8_t size);
 
-ADC_StatusTypeDef        ADC_ReadChannel(ADC_HandleTypeDef* hadc, uint8_t channel, uint16_t*  retval);
+ADC_StatusTypeDef        ADC_SetScaleFixed(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t max);
+
+ADC_StatusTypeDef        ADC_GetValueFixed(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t* retval);
+
+ADC_StatusTypeDef        ADC_SetFilterBoxcar(ADC_ContextTypeDef* ctx, uint8_t channel);
+
+#if ADC_USE_EMA
+ADC_StatusTypeDef        ADC_SetFilterEMA(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t shift);
+#endif
+
+#if ADC_USE_NOTCH
+ADC_StatusTypeDef        ADC_SetNotch(ADC_ContextTypeDef* ctx, float sampleRate, float frequency, uint8_t harmonics);
+
+ADC_StatusTypeDef        ADC_SetFilterNotch(ADC_ContextTypeDef* ctx, uint8_t channel);
+#endif
+
+#if ADC_USE_MEDIAN
+ADC_StatusTypeDef        ADC_SetMedian(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t size, uint8_t trim);
+#endif
 
-__weak ADC_StatusTypeDef ADC_GetValue(ADC_HandleTypeDef* hadc, float max, uint8_t channel, float * retval);
+#if ADC_USE_STATS
+ADC_StatusTypeDef        ADC_SetStatsWindow(ADC_ContextTypeDef* ctx, uint8_t channel, uint32_t length);
+
+ADC_StatusTypeDef        ADC_ReadStats(ADC_ContextTypeDef* ctx, uint8_t channel, ADC_StatsSnapshotTypeDef* stats);
+
+ADC_StatusTypeDef        ADC_ReadAllStats(ADC_ContextTypeDef* ctx, ADC_StatsSnapshotTypeDef* stats, uint8_t size);
+#endif
+
+#if ADC_USE_POWER
+ADC_StatusTypeDef        ADC_SetPowerPair(ADC_ContextTypeDef* ctx, uint8_t pair, uint8_t channelVoltage, uint8_t channelCurrent,
+										  uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length);
+
+ADC_StatusTypeDef        ADC_SetPowerPairDual(ADC_ContextTypeDef* ctx, uint8_t pair, uint8_t channelVoltage, uint8_t channelCurrent,
+											  uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length);
+
+ADC_StatusTypeDef        ADC_ReadPower(ADC_ContextTypeDef* ctx, uint8_t pair, ADC_PowerSnapshotTypeDef* power);
+#endif
+
+#if ADC_USE_GOERTZEL
+ADC_StatusTypeDef        ADC_SetToneBin(ADC_ContextTypeDef* ctx, uint8_t bin, uint8_t channel, float sampleRate, float frequency, uint32_t length, float* actual);
+
+ADC_StatusTypeDef        ADC_ReadTone(ADC_ContextTypeDef* ctx, uint8_t bin, float* amplitude);
+#endif
+
+#if ADC_USE_WATCHDOG
+ADC_StatusTypeDef        ADC_SetWatchdog(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t low, uint16_t high, uint16_t hysteresis, uint16_t debounce);
+
+ADC_StatusTypeDef        ADC_SetWatchdogCallback(ADC_ContextTypeDef* ctx, ADC_WatchdogCallbackTypeDef callback);
+
+ADC_StatusTypeDef        ADC_GetWatchdogState(ADC_ContextTypeDef* ctx, uint8_t channel, ADC_WatchdogStateTypeDef* state);
+#endif
+
+#if ADC_USE_TIMER_TRIGGER
+ADC_StatusTypeDef        ADC_SetTimerTrigger(ADC_ContextTypeDef* ctx, TIM_HandleTypeDef* htim, uint32_t trigger, uint32_t sampleRate);
+#endif
+
+ADC_StatusTypeDef        ADC_GetSampleRate(ADC_ContextTypeDef* ctx, float* sampleRate);
+
+#if ADC_USE_INJECTED
+ADC_StatusTypeDef        ADC_SetInjected(ADC_ContextTypeDef* ctx, const uint8_t* channels, uint8_t count, uint32_t samplingTime, uint32_t trigger,
+										 ADC_InjectedCallbackTypeDef callback);
+
+ADC_StatusTypeDef        ADC_ReadInjected(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t* retval);
+
+ADC_StatusTypeDef        ADC_ReadAllInjected(ADC_ContextTypeDef* ctx, uint16_t* values);
+#endif
+
+#if ADC_USE_CALIBRATION
+ADC_StatusTypeDef        ADC_SetCalibration(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t offset, int32_t gain, const ADC_CalibrationTableTypeDef* table);
+#endif
+
+#if ADC_USE_CAPTURE
+ADC_StatusTypeDef        ADC_SetCapture(ADC_ContextTypeDef* ctx, const uint8_t* channels, uint8_t count, uint16_t decimation,
+										uint16_t preTrigger, uint16_t postTrigger, uint8_t freezeOnFault);
+
+ADC_StatusTypeDef        ADC_TriggerCapture(ADC_ContextTypeDef* ctx);
+
+ADC_StatusTypeDef        ADC_ArmCapture(ADC_ContextTypeDef* ctx);
+
+ADC_StatusTypeDef        ADC_GetCapture(ADC_ContextTypeDef* ctx, const ADC_CaptureEntryTypeDef** entries, uint16_t* count);
+#endif
+
+#if ADC_USE_SUBSCRIPTION
+ADC_StatusTypeDef        ADC_SetSubscription(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t divider);
+#endif
+
+#if ADC_USE_OVERSAMPLING
+ADC_StatusTypeDef        ADC_SetOversampling(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t shift);
+
+ADC_StatusTypeDef        ADC_ReadOversampled(ADC_ContextTypeDef* ctx, uint8_t channel, uint32_t* retval, uint8_t* bits);
+#endif
+
+void                     HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
 
 void                     HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
 
-ADC_StatusTypeDef        ADC_Config_GetRanksOfChannels(ADC_HandleTypeDef* hadc);
+#if ADC_USE_INJECTED
+void                     HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc);
+#endif
+
+ADC_StatusTypeDef        ADC_Config_GetRanksOfChannels(ADC_ContextTypeDef* ctx);
 
 ADC_StatusTypeDef        ADC_GetRank(ADC_ChannelsTypeDef *cadc, uint8_t channel, uint8_t* rank);
 
-ADC_StatusTypeDef        ADC_Averaging(ADC_HandleTypeDef* hadc, ADC_BufferTypeDef* badc, uint8_t channel , uint16_t* retval);
+ADC_StatusTypeDef        ADC_Averaging(ADC_ContextTypeDef* ctx, uint8_t channel , uint16_t* retval);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* INC_ADC_DRIVER_H_ */
@@ -0,0 +1,514 @@
+/**
+  ******************************************************************************
+  * @file    adc_filters.h
+  * @author  Bartosz Rychlicki
+  * @Title   Universal driver for ADC peripheral
+  * @brief   This file contains typedefs and prototypes of per-channel processing stages, which run on completed halves of DMA buffer.
+  * 		 Stages work on rank-interleaved blocks and know nothing about ADC registers, ADC driver binds them to channels
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 AGH Eko-Energy.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INC_ADC_FILTERS_H_
+#define INC_ADC_FILTERS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ----------------------------------------------------------------------------*/
+#include "main.h"
+#include "adc_config.h"
+
+/* Private Typedefs ------------------------------------------------------------------- */
+/**
+  * @brief  Filter modes definition | selects value returned by ADC_ReadChannel for channel
+  */
+typedef enum{
+	ADC_FILTER_BOXCAR = 0,										// running average of ADC_AVERAGED_MEASURES samples (default)
+	ADC_FILTER_EMA,												// exponential moving average, one accumulator per channel
+	ADC_FILTER_NOTCH											// notch filter tuned to ripple frequency and its harmonics
+
+}ADC_FilterModeTypeDef;
+
+
+/**
+  * @brief  Oversampling and decimation state of rank | 4^n samples are summed and shifted by n, result has n extra bits
+  */
+typedef struct{
+
+	uint32_t 		  acc;										// sum of samples in current decimation period
+
+	uint16_t 		  count;									// samples left in current decimation period
+
+	uint8_t  		  shift;									// n of 4^n oversampling, 0 - stage disabled
+
+	volatile uint32_t output;									// last decimated value
+
+	volatile uint32_t outputs;									// number of decimated values | lets readers detect new value
+
+}ADC_OversamplingTypeDef;
+
+
+/**
+  * @brief  Exponential moving average state of rank | acc = acc - (acc >> k) + sample, filtered value is acc >> k
+  */
+typedef struct{
+
+	volatile uint32_t acc;										// accumulator, holds filtered value scaled by 2^k
+
+	uint8_t 		  shift;									// k, time constant of 2^k samples | 0 - stage disabled
+
+}ADC_EmaTypeDef;
+
+
+/**
+  * @brief  Median prefilter state of rank | sorted window of last samples, mean of samples left after trimming both ends
+  */
+typedef struct{
+
+	uint16_t window[ADC_MEDIAN_MAX_SIZE];						// last samples of rank, ring
+
+	uint8_t  size;												// window of 3, 5, 7 or 9 samples, 0 - stage disabled
+
+	uint8_t  trim;												// samples dropped at each end of sorted window, (size - 1) / 2 - median
+
+	uint8_t  position;											// oldest sample of window
+
+	uint8_t  primed;											// 1 - window seeded by first sample
+
+}ADC_MedianTypeDef;
+
+
+/**
+  * @brief  Statistics of one completed window of channel
+  */
+typedef struct{
+
+	uint16_t min;												// minimal sample of window
+
+	uint16_t max;												// maximal sample of window
+
+	uint16_t mean;												// mean of window
+
+	uint16_t peakToPeak;										// max - min
+
+	uint32_t windows;											// number of windows completed since start
+
+}ADC_StatsSnapshotTypeDef;
+
+
+/**
+  * @brief  Statistics state of rank | window in progress and last completed window
+  */
+typedef struct{
+
+	uint32_t 		  sum;										// sum of samples of window in progress
+
+	uint32_t 		  count;									// samples of window in progress
+
+	uint32_t 		  length;									// window length in samples, 0 - stage disabled
+
+	uint16_t 		  min;										// min of window in progress
+
+	uint16_t 		  max;										// max of window in progress
+
+	volatile uint16_t resultMin;								// last completed window
+
+	volatile uint16_t resultMax;
+
+	volatile uint16_t resultMean;
+
+	volatile uint32_t windows;									// number of completed windows
+
+}ADC_StatsTypeDef;
+
+
+/**
+  * @brief  RMS and active power of one completed window of channel pair | values in LSB and LSB^2
+  */
+typedef struct{
+
+	uint16_t rmsVoltage;										// RMS of voltage channel, offset removed
+
+	uint16_t rmsCurrent;										// RMS of current channel, offset removed
+
+	int32_t  power;												// mean of voltage * current products
+
+	uint32_t updates;											// number of windows completed since start
+
+}ADC_PowerSnapshotTypeDef;
+
+
+/**
+  * @brief  Power state of channel pair | 64-bit sums of squares and cross products of window in progress
+  */
+typedef struct{
+
+	int64_t 		  sumVV;									// sum of voltage squares
+
+	int64_t 		  sumII;									// sum of current squares
+
+	int64_t 		  sumVI;									// sum of voltage * current products
+
+	uint32_t 		  count;									// samples of window in progress
+
+	uint32_t 		  length;									// window length in samples, update rate, 0 - pair disabled
+
+	uint16_t 		  offsetVoltage;							// zero of voltage channel | |sample - offset| < 32768
+
+	uint16_t 		  offsetCurrent;							// zero of current channel | |sample - offset| < 32768
+
+	uint8_t 		  rankVoltage;								// rank of voltage channel
+
+	uint8_t 		  rankCurrent;								// rank of current channel
+
+	uint8_t 		  currentSlave;								// 1 - current channel is converted by slave ADC of dual mode
+
+	volatile uint16_t rmsVoltage;								// last completed window
+
+	volatile uint16_t rmsCurrent;
+
+	volatile int32_t  power;
+
+	volatile uint32_t updates;									// number of completed windows
+
+}ADC_PowerTypeDef;
+
+
+/**
+  * @brief  Goertzel bin state | resonator at frequency of bin, evaluated after every block of length samples
+  */
+typedef struct{
+
+	int32_t 		  coeff;									// 2cos(2 pi k / length) | Q ADC_GOERTZEL_COEFF_Q
+
+	int32_t 		  s1;										// resonator state, last output
+
+	int32_t 		  s2;										// resonator state, output before last
+
+	uint32_t 		  count;									// samples of block in progress
+
+	uint32_t 		  length;									// block length in samples, 0 - bin disabled
+
+	uint8_t 		  rank;										// rank of analysed channel
+
+	volatile uint64_t power;									// |X(k)|^2 of last completed block
+
+	volatile uint32_t updates;									// number of completed blocks
+
+}ADC_GoertzelTypeDef;
+
+
+/**
+  * @brief  Software watchdog states of channel
+  */
+typedef enum{
+	ADC_WATCHDOG_NORMAL = 0,									// value within thresholds
+	ADC_WATCHDOG_HIGH,											// value above high threshold
+	ADC_WATCHDOG_LOW											// value below low threshold
+
+}ADC_WatchdogStateTypeDef;
+
+
+/**
+  * @brief  Watchdog event handler | called from DMA callback at every change of state of rank
+  */
+typedef void (*ADC_WatchdogHandlerTypeDef)(void* owner, uint8_t rank, ADC_WatchdogStateTypeDef state, uint16_t value);
+
+
+/**
+  * @brief  Software watchdog state of rank | state changes after debounce consecutive samples beyond threshold
+  */
+typedef struct{
+
+	uint16_t 		 high;										// high threshold, left below high - hysteresis
+
+	uint16_t 		 low;										// low threshold, left above low + hysteresis
+
+	uint16_t 		 hysteresis;								// hysteresis of both thresholds
+
+	uint16_t 		 debounce;									// consecutive samples needed to change state, 0 - watchdog disabled
+
+	uint16_t 		 count;										// consecutive samples voting for pending state
+
+	uint8_t 		 pending;									// state voted by counted samples, ADC_WatchdogStateTypeDef
+
+	volatile uint8_t state;										// ADC_WatchdogStateTypeDef
+
+}ADC_WatchdogTypeDef;
+
+
+/**
+  * @brief  Capture ring states
+  */
+typedef enum{
+	ADC_CAPTURE_IDLE = 0,										// capture not configured
+	ADC_CAPTURE_ARMED,											// recording, waiting for trigger
+	ADC_CAPTURE_TRIGGERED,										// recording post-trigger entries
+	ADC_CAPTURE_FROZEN											// recording stopped, ring can be exported
+
+}ADC_CaptureStateTypeDef;
+
+
+#define ADC_CAPTURE_PERIOD_Q	8U								// fractional bits of scan period, sub-tick periods of HAL tick stay exact over DMA half
+
+/**
+  * @brief  Capture entry | one decimated scan of recorded channels
+  */
+typedef struct{
+
+	uint32_t timestamp;											// ADC_CAPTURE_TIMESTAMP of scan, interpolated back from end of DMA half
+
+	uint16_t sample[ADC_CAPTURE_CHANNELS];						// raw samples in order of configured channels
+
+}ADC_CaptureEntryTypeDef;
+
+
+/**
+  * @brief  Capture ring of one ADC
+  */
+typedef struct{
+
+	ADC_CaptureEntryTypeDef entry[ADC_CAPTURE_DEPTH];			// ring of entries
+
+	uint8_t 				rank[ADC_CAPTURE_CHANNELS];			// ranks of recorded channels
+
+	uint8_t 				channels;							// number of recorded channels
+
+	uint8_t 				freezeOnFault;						// 1 - watchdog event triggers capture
+
+	uint32_t 				scanPeriod;							// timestamp ticks between scans in Q ADC_CAPTURE_PERIOD_Q, 0 - entries of block share its timestamp
+
+	uint16_t 				decimation;							// every decimation-th scan is recorded
+
+	uint16_t 				phase;								// scans left to next recorded scan
+
+	uint16_t 				head;								// next written entry
+
+	uint16_t 				count;								// valid entries
+
+	uint16_t 				preTrigger;							// entries kept before trigger
+
+	uint16_t 				postTrigger;						// entries recorded after trigger
+
+	uint16_t 				remaining;							// post-trigger entries left to record
+
+	volatile uint8_t 		state;								// ADC_CaptureStateTypeDef
+
+}ADC_CaptureTypeDef;
+
+
+/**
+  * @brief  Notch biquad section | H(z) = b0 (1 + b1/b0 z^-1 + z^-2) / (1 + a1 z^-1 + a2 z^-2), unity gain at DC
+  */
+typedef struct{
+
+	int32_t b0;													// numerator, b2 = b0 | Q ADC_NOTCH_COEFF_Q
+
+	int32_t b1;													// numerator | Q ADC_NOTCH_COEFF_Q
+
+	int32_t a1;													// denominator | Q ADC_NOTCH_COEFF_Q
+
+	int32_t a2;													// denominator | Q ADC_NOTCH_COEFF_Q
+
+}ADC_NotchSectionTypeDef;
+
+
+/**
+  * @brief  Notch coefficients of one ADC | all channels share sample rate and ripple frequency
+  */
+typedef struct{
+
+	ADC_NotchSectionTypeDef section[ADC_NOTCH_MAX_HARMONICS];	// one section per harmonic
+
+	uint8_t 				sections;							// number of designed sections, 0 - notch not designed
+
+}ADC_NotchBankTypeDef;
+
+
+/**
+  * @brief  Notch state of rank | cascade of sections in direct form I
+  */
+typedef struct{
+
+	int32_t 		  z[ADC_NOTCH_MAX_HARMONICS + 1][2];		// z[0] - input history, z[k + 1] - output history of section k | Q ADC_NOTCH_STATE_Q
+
+	volatile int32_t  output;									// last filtered value | Q ADC_NOTCH_STATE_Q
+
+	uint8_t 		  enabled;									// 1 - rank is filtered
+
+	uint8_t 		  primed;									// 1 - histories seeded by first sample
+
+}ADC_NotchTypeDef;
+
+
+/**
+  * @brief  Processing stages of all ranks of one ADC
+  */
+typedef struct{
+
+	uint8_t 				mode[ADC_SEQUENCE_LENGTH];			// filter mode of every rank, ADC_FilterModeTypeDef
+
+#if ADC_USE_SUBSCRIPTION
+	uint32_t 				lazy;								// bitmask of ranks not processed in DMA callbacks, their values are computed on read
+
+	uint32_t 				active;								// bitmask of ranks processed in current block
+
+	uint16_t 				divider[ADC_SEQUENCE_LENGTH];		// rank is processed in every divider-th block, 0 and 1 - every block
+
+	uint16_t 				countdown[ADC_SEQUENCE_LENGTH];		// blocks skipped until next processing of rank
+#endif
+
+#if ADC_USE_MEDIAN
+	ADC_MedianTypeDef 		median[ADC_SEQUENCE_LENGTH];		// median prefilter of every rank
+#endif
+
+#if ADC_USE_OVERSAMPLING
+	ADC_OversamplingTypeDef oversampling[ADC_SEQUENCE_LENGTH];	// oversampling of every rank
+#endif
+
+#if ADC_USE_EMA
+	ADC_EmaTypeDef 			ema[ADC_SEQUENCE_LENGTH];			// exponential moving average of every rank
+#endif
+
+#if ADC_USE_STATS
+	ADC_StatsTypeDef 		stats[ADC_SEQUENCE_LENGTH];			// window statistics of every rank
+#endif
+
+#if ADC_USE_POWER
+	ADC_PowerTypeDef 		power[ADC_POWER_MAX_PAIRS];			// RMS and active power of channel pairs
+#endif
+
+#if ADC_USE_GOERTZEL
+	ADC_GoertzelTypeDef 	goertzel[ADC_GOERTZEL_MAX_BINS];	// Goertzel bins
+#endif
+
+#if ADC_USE_WATCHDOG
+	ADC_WatchdogTypeDef 	watchdog[ADC_SEQUENCE_LENGTH];		// software watchdog of every rank
+
+	ADC_WatchdogHandlerTypeDef watchdogHandler;				// handler of watchdog events, NULL - state is only stored
+
+	void* 					watchdogOwner;						// first argument of handler
+#endif
+
+#if ADC_USE_CAPTURE
+	ADC_CaptureTypeDef 		capture;							// timestamped capture ring
+#endif
+
+#if ADC_USE_NOTCH
+	ADC_NotchBankTypeDef 	notchBank;							// notch coefficients shared by ranks
+
+	ADC_NotchTypeDef 		notch[ADC_SEQUENCE_LENGTH];			// notch state of every rank
+#endif
+
+}ADC_FiltersTypeDef;
+
+
+/* Private Macros (Function type)------------------------------------------------------------------- */
+#if ADC_USE_SUBSCRIPTION
+#define ADC_FILTERS_ACTIVE(__FILTERS__)  ((__FILTERS__)->active)			// ranks scheduled by ADC_Filters_Schedule
+#else
+#define ADC_FILTERS_ACTIVE(__FILTERS__)  (0xFFFFFFFFUL)					// every rank in every block
+#endif
+
+
+/* Private functions Prototypes -------------------------------------------------------  */
+void ADC_Filters_Reset(ADC_FiltersTypeDef* filters);
+
+#if ADC_USE_SUBSCRIPTION
+void ADC_Filters_Schedule(ADC_FiltersTypeDef* filters, uint8_t ranks);
+#endif
+
+uint32_t ADC_Filters_SampleRanks(const ADC_FiltersTypeDef* filters, uint8_t ranks);
+
+void ADC_Filters_PrefilterBlock(ADC_FiltersTypeDef* filters, uint16_t* block, uint8_t ranks, uint32_t scans);
+
+void ADC_Filters_ProcessBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, uint32_t scans);
+
+void ADC_Filters_ProcessDualBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, const uint16_t* slaveBlock, uint8_t slaveRanks, uint32_t scans);
+
+uint32_t ADC_Kernel_Sum(const uint16_t* samples, uint32_t stride, uint32_t count);
+
+uint64_t ADC_Kernel_SumSquares(const uint16_t* samples, uint32_t stride, uint32_t count, uint16_t offset);
+
+uint32_t ADC_Kernel_SumMinMax(const uint16_t* samples, uint32_t stride, uint32_t count, uint16_t* min, uint16_t* max);
+
+#if ADC_USE_MEDIAN
+void ADC_Median_Config(ADC_MedianTypeDef* median, uint8_t size, uint8_t trim);
+
+void ADC_Median_ProcessBlock(ADC_MedianTypeDef* median, uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active);
+#endif
+
+#if ADC_USE_OVERSAMPLING
+void ADC_Oversampling_Config(ADC_OversamplingTypeDef* os, uint8_t shift);
+
+void ADC_Oversampling_ProcessBlock(ADC_OversamplingTypeDef* os, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active);
+#endif
+
+#if ADC_USE_EMA
+void ADC_Ema_Config(ADC_EmaTypeDef* ema, uint8_t shift);
+
+void ADC_Ema_ProcessBlock(ADC_EmaTypeDef* ema, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active);
+#endif
+
+#if ADC_USE_STATS
+void ADC_Stats_Config(ADC_StatsTypeDef* stats, uint32_t length);
+
+void ADC_Stats_ProcessBlock(ADC_StatsTypeDef* stats, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active);
+
+void ADC_Stats_Read(const ADC_StatsTypeDef* stats, ADC_StatsSnapshotTypeDef* snapshot);
+#endif
+
+#if ADC_USE_POWER
+void ADC_Power_Config(ADC_PowerTypeDef* power, uint8_t rankVoltage, uint8_t rankCurrent, uint8_t currentSlave,
+					  uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length);
+
+void ADC_Power_ProcessBlock(ADC_PowerTypeDef* power, const uint16_t* voltageBlock, uint8_t voltageRanks,
+							const uint16_t* currentBlock, uint8_t currentRanks, uint32_t scans);
+
+void ADC_Power_Read(const ADC_PowerTypeDef* power, ADC_PowerSnapshotTypeDef* snapshot);
+#endif
+
+#if ADC_USE_GOERTZEL
+void ADC_Goertzel_Config(ADC_GoertzelTypeDef* bin, uint8_t rank, uint32_t k, uint32_t length);
+
+void ADC_Goertzel_ProcessBlock(ADC_GoertzelTypeDef* bin, const uint16_t* block, uint8_t ranks, uint32_t scans);
+#endif
+
+#if ADC_USE_WATCHDOG
+void ADC_Watchdog_Config(ADC_WatchdogTypeDef* watchdog, uint16_t low, uint16_t high, uint16_t hysteresis, uint16_t debounce);
+
+void ADC_Watchdog_ProcessBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, uint32_t scans);
+#endif
+
+#if ADC_USE_CAPTURE
+void ADC_Capture_Arm(ADC_CaptureTypeDef* capture);
+
+void ADC_Capture_Trigger(ADC_CaptureTypeDef* capture);
+
+void ADC_Capture_ProcessBlock(ADC_CaptureTypeDef* capture, const uint16_t* block, uint8_t ranks, uint32_t scans);
+
+uint16_t ADC_Capture_Export(ADC_CaptureTypeDef* capture, const ADC_CaptureEntryTypeDef** entries);
+#endif
+
+#if ADC_USE_NOTCH
+uint8_t  ADC_Notch_Design(ADC_NotchBankTypeDef* bank, float sampleRate, float frequency, uint8_t harmonics);
+
+void     ADC_Notch_Config(ADC_NotchTypeDef* notch, uint8_t enabled);
+
+void     ADC_Notch_ProcessBlock(const ADC_NotchBankTypeDef* bank, ADC_NotchTypeDef* notch, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active);
+
+uint16_t ADC_Notch_Read(const ADC_NotchTypeDef* notch);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_ADC_FILTERS_H_ */
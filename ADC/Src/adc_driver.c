@@ -17,115 +17,255 @@
 
 
 #include "adc_driver.h"
+#include <math.h>
 
 /* Private Variables-------------------------------------------------------  */
-ADC_ChannelsTypeDef    cadc;
-ADC_BufferTypeDef 	   badc;
+static ADC_ContextTypeDef* contexts[ADC_MAX_INSTANCES];		// registered contexts | used to resolve context in HAL callbacks
+
+/* Exported Variables-------------------------------------------------------  */
+const ADC_FootprintTypeDef ADC_Footprint = {
+	.sequenceLength  = ADC_SEQUENCE_LENGTH,
+	.buffer          = sizeof(ADC_BufferTypeDef),
+	.separateBuffers = ADC_BUFF_SIZE * (ADC_USE_MULTIMODE * sizeof(uint32_t) + sizeof(uint16_t)) + ADC_USE_MULTIMODE * ADC_HALF_BUFF_SIZE * sizeof(uint16_t) + ADC_CHANNEL_IDS * sizeof(uint32_t) + sizeof(ADC_PingPongTypeDef),
+	.block           = ADC_USE_MULTIMODE * ADC_HALF_BUFF_SIZE * sizeof(uint16_t),
+	.averaging       = sizeof(ADC_AveragingTypeDef),
+	.context         = sizeof(ADC_ContextTypeDef),
+};
+
+/* Private Macros-----------------------------------------------------------  */
+#define ADC_DMA_LENGTH(__CTX__)  (2U * ADC_DMA_HALF_SCANS * (__CTX__)->config.convertedChannels)		// ping-pong buffer length, sized to converted channels
+
+/* Private Functions Prototypes---------------------------------------------  */
+static ADC_StatusTypeDef ADC_Config_Snapshot(ADC_ContextTypeDef* ctx);
+static HAL_StatusTypeDef ADC_Start(ADC_ContextTypeDef* ctx);
+static void              ADC_ResetFixedScale(ADC_ContextTypeDef* ctx);
+static void              ADC_UpdateFixedScale(ADC_ContextTypeDef* ctx, uint8_t rank);
+static HAL_StatusTypeDef ADC_Stop(ADC_ContextTypeDef* ctx);
+static HAL_StatusTypeDef ADC_StartDMA(ADC_ContextTypeDef* ctx);
+static void              ADC_ResetAveraging(ADC_AveragingTypeDef* avg);
+static uint16_t          ADC_FilteredValue(ADC_ContextTypeDef* ctx, uint8_t rank);
+static int32_t           ADC_FixedValue(ADC_ContextTypeDef* ctx, uint8_t rank, uint16_t raw);
+#if ADC_USE_SUBSCRIPTION
+static uint16_t          ADC_LazyValue(ADC_ContextTypeDef* ctx, uint8_t rank);
+#endif
+#if ADC_USE_HW_OVERSAMPLING
+static void              ADC_HwOversampling(ADC_HandleTypeDef* hadc);
+#endif
+#if ADC_USE_TIMER_TRIGGER
+static uint32_t          ADC_TimerClock(TIM_TypeDef* instance);
+#endif
+#if ADC_USE_CAPTURE
+static void              ADC_CapturePeriod(ADC_ContextTypeDef* ctx);
+#endif
+static void              ADC_ProcessHalf(ADC_ContextTypeDef* ctx, uint8_t half);
+#if ADC_USE_MULTIMODE
+static void              ADC_Deinterleave(ADC_ContextTypeDef* ctx, const uint32_t* packed, uint32_t length);
+#endif
+static void              ADC_AccumulateBlock(ADC_ContextTypeDef* ctx, uint16_t* block, uint32_t scans);
+static void              ADC_AccumulateSample(ADC_AveragingTypeDef* avg, uint8_t rank, uint16_t sample);
+static void              ADC_AdvanceAveraging(ADC_AveragingTypeDef* avg);
+#if ADC_USE_WATCHDOG
+static void              ADC_WatchdogDispatch(void* owner, uint8_t rank, ADC_WatchdogStateTypeDef state, uint16_t value);
+#endif
+
 /**
-  * @brief ADC1 Initialization Function, does calibration
+  * @brief ADC Initialization Function, does calibration, registers context and starts conversions
+  * 	   In dual mode slave context has to be linked by ADC_InitSlave before, then slave is calibrated here as well
+  * @param  ctx    - pointer to ADC context, owned by caller | should be static (zeroed), must live as long as ADC is running
   * @param  hadc   - pointer to ADC handle
+  * @param  buffer - pointer to DMA buffer, owned by caller like context | NULL if ADC runs in polling mode
+  * @retval status - HAL status, HAL_ERROR if all contexts are already registered or DMA is enabled without buffer
+  */
+HAL_StatusTypeDef ADC_Init(ADC_ContextTypeDef* ctx, ADC_HandleTypeDef* hadc, ADC_BufferTypeDef* buffer){
+
+	int free = -1; // first free slot in contexts
+
+	// searching for context slot, context of the same ADC is replaced
+	for(int i = 0; i < ADC_MAX_INSTANCES; ++i){
+		if(contexts[i] != NULL && contexts[i]->hadc == hadc){
+			free = i;
+			break;
+		}
+
+		if(contexts[i] == NULL && free < 0){
+			free = i;
+		}
+	}
+
+	if(free < 0){
+		return HAL_ERROR;
+	}
+
+	ctx->hadc   = hadc;
+	ctx->badc   = buffer;
+	ctx->master = NULL;
+
+	ADC_ResetFixedScale(ctx);
+
+#if ADC_USE_HW_OVERSAMPLING
+	ADC_HwOversampling(hadc);
+#endif
+
+	// taking configuration snapshot, number of conversions is needed to size DMA transfer
+	if(ADC_Config_Snapshot(ctx) != ADC_OK){
+		return HAL_ERROR;
+	}
+
+	// launching calibration, before conversions are started (calibration disables ADC)
+	if(__ADC_CALIBRATE(hadc) != HAL_OK){
+		return HAL_ERROR;
+	}
+
+	if(ctx->slave != NULL && __ADC_CALIBRATE(ctx->slave->hadc) != HAL_OK){
+		return HAL_ERROR;
+	}
+
+	// dual mode converts master and slave ranks in pairs, sequences must have the same length
+	if(ctx->slave != NULL && ctx->slave->config.convertedChannels != ctx->config.convertedChannels){
+		return HAL_ERROR;
+	}
+
+	contexts[free] = ctx;
+
+	return ADC_Start(ctx);
+}
+
+/**
+  * @brief ADC Initialization Function of slave ADC in dual mode | links slave context to master context
+  * 	   Must be called before ADC_Init of master, which calibrates slave and starts common DMA
+  * @param  ctx    - pointer to slave ADC context
+  * @param  hadc   - pointer to slave ADC handle
+  * @param  master - pointer to master ADC context, which owns DMA
   * @retval status - HAL status
   */
-HAL_StatusTypeDef ADC_Init(ADC_HandleTypeDef* hadc){
+HAL_StatusTypeDef ADC_InitSlave(ADC_ContextTypeDef* ctx, ADC_HandleTypeDef* hadc, ADC_ContextTypeDef* master){
+
+	ctx->hadc   = hadc;
+	ctx->badc   = NULL; // measures are split into ctx->block by master's DMA callbacks
+	ctx->master = master;
+	ctx->slave  = NULL;
 
-	// check if ADC is not started
-	if(__ADC_IS_CONV_STARTED(hadc) == 0){
-		HAL_ADC_Start(hadc);
+	ADC_ResetFixedScale(ctx);
+
+#if ADC_USE_HW_OVERSAMPLING
+	ADC_HwOversampling(hadc);
+#endif
+
+	// detecting ranks of slave channels, sequence length must be the same as master's
+	if(ADC_Config_Snapshot(ctx) != ADC_OK){
+		return HAL_ERROR;
 	}
 
-	// check if dma is enabled
-	if(__ADC_DMA_MODE(hadc) != 0){
+	ADC_ResetAveraging(&ctx->aadc);
 
-		// check if multimode is enabled
-		if(__ADC_MULTIMODE_IS_ENABLED(hadc) != 0){
+	// linking slave as last step, master's DMA callbacks deliver slave measures
+	master->slave = ctx;
 
-			// starting DMA with ADC in dual mode
-			if(HAL_ADCEx_MultiModeStart_DMA(hadc, badc.ddma.BufferMultiMode, ADC_CONVERTED_CHANNELS) != HAL_OK){
-				return ADC_Error;
-			}
+	return HAL_OK;
+}
 
-		}else{
+/**
+  * @brief ADC Reconfiguration Function | to be called after ADC or DMA settings were changed at runtime
+  * 	   Stops conversions, takes new configuration snapshot and restarts conversions. Averages are invalid until rings are filled again
+  * @param  ctx    - pointer to ADC context initialized by ADC_Init
+  * @retval status - HAL status
+  */
+HAL_StatusTypeDef ADC_Reconfigure(ADC_ContextTypeDef* ctx){
 
-			// starting DMA with ADC in Independent mode
-			if(HAL_ADC_Start_DMA(hadc, (uint32_t*)badc.idma.BufferADC, ADC_CONVERTED_CHANNELS) != HAL_OK){
-				return ADC_Error;
-			}
+	// stopping DMA, buffer layout and length can change
+	if(ADC_Stop(ctx) != HAL_OK){
+		return HAL_ERROR;
+	}
+
+	if(ADC_Config_Snapshot(ctx) != ADC_OK){
+		return HAL_ERROR;
+	}
+
+	if(ctx->slave != NULL && ADC_Config_Snapshot(ctx->slave) != ADC_OK){
+		return HAL_ERROR;
+	}
+
+	return ADC_Start(ctx);
+}
+
+/**
+  * @brief ADC context return function | resolves context registered for ADC handle
+  * @param  hadc   - pointer to ADC handle
+  * @retval ctx    - pointer to ADC context, NULL if ADC is not handled by driver
+  */
+ADC_ContextTypeDef* ADC_GetContext(ADC_HandleTypeDef* hadc){
 
+	for(int i = 0; i < ADC_MAX_INSTANCES; ++i){
+		if(contexts[i] != NULL && contexts[i]->hadc == hadc){
+			return contexts[i];
 		}
 
+		// slave is not registered, its interrupts (e.g. injected group) are resolved through master
+		if(contexts[i] != NULL && contexts[i]->slave != NULL && contexts[i]->slave->hadc == hadc){
+			return contexts[i]->slave;
+		}
 	}
 
-	// launching calibration
-	return HAL_ADCEx_Calibration_Start(hadc);
+	return NULL;
 }
 
 /**
   * @brief ADC Reading channel function
-  * @param  hadc    - pointer to ADC handle
+  * @param  ctx     - pointer to ADC context
   * @param  channel - number of channel to be read
   * @param  retval  - pointer to variable, whose contains return value
   * @retval status  - HAL status if Reading channel went successfully
   */
-ADC_StatusTypeDef ADC_ReadChannel(ADC_HandleTypeDef* hadc, uint8_t channel, uint16_t*  retval){
+ADC_StatusTypeDef ADC_ReadChannel(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t*  retval){
 
-	ADC_StatusTypeDef status;
+	ADC_HandleTypeDef* hadc   = ctx->hadc;
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	ADC_StatusTypeDef status  = ADC_OK;
+	uint8_t rank              = 0;
 
-	if(__ADC_IS_CONV_STARTED(hadc) == 0){ // ADC not started
-		return ADC_NotStarted;
-	}
-	if(channel < 0 || channel > 16){
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
 		return ADC_Error;
 	}
 
-	uint8_t rank  = 0;
-
-	if(ADC_GetRank(&cadc, channel, &rank) != ADC_OK){
-		return ADC_Error;
-	}
 
+	if(owner->config.mode == ADC_MODE_POLLING){  // DMA Disabled
 
-	if(__ADC_IS_DMA_ENABLED(hadc) == 0){  // DMA Disabled
+		if(__ADC_IS_CONV_STARTED(hadc) == 0){ // ADC not started
+			return ADC_NotStarted;
+		}
 
+		uint32_t value = 0;
 
 		for(int i  = 0 ; i <= rank ; ++i){
-			 if(__ADC_IS_DMA_MULTIMODE(hadc) == 0){  // single conversion | independent mode
-				 badc.ADC_Buff[channel]          = HAL_ADC_GetValue(hadc);
-
-			}else{									 // single conversion | dual mode
-				 badc.ddma.BufferMultiMode[rank] = HAL_ADCEx_MultiModeGetValue(hadc);
-			}
+			 value = HAL_ADC_GetValue(hadc); // single conversion | independent mode
 		}
 
-		if(badc.ADC_Buff[channel] > __ADC_RESOLUTION(hadc) || badc.ADC_Buff[channel] < 0){
+		if(value > ctx->config.resolution){
 			return  ADC_Error;
 		}
 
-		status =  ADC_OK;
+		*retval = (uint16_t)value;
+		status  = ADC_OK;
 
 	}else{								  // DMA Enabled
 
 
-		if(ADC_Averaging(hadc, &badc, channel, retval) != ADC_OK){ // averaging transfer
-			return ADC_Error;
+		if(ctx->filters.mode[rank] == ADC_FILTER_BOXCAR){
+			status = ADC_Averaging(ctx, channel, retval); // running sum maintained in DMA callbacks
+		}else if(owner->pp.isReady == 0){			  // filters are seeded by first completed half
+			status = ADC_Busy;
+		}else{
+			*retval = ADC_FilteredValue(ctx, rank);
 		}
 
-
-		if(__ADC_MULTIMODE_IS_ENABLED(hadc) != 0){ // ADC in dual mode | DMA [ON]
-
-
-			if(__ADC_DMA_MODE(hadc) == 0){
-				if(HAL_ADCEx_MultiModeStart_DMA(hadc, badc.ddma.BufferMultiMode, ADC_CONVERTED_CHANNELS) != HAL_OK){
-					return ADC_Error;
-				}
-			}
-
-		}else{									   // ADC in independent mode | DMA [ON]
+		if(status != ADC_OK){
+			return status;
+		}
 
 
-			if(__ADC_DMA_MODE(hadc) == 0){
-				if(HAL_ADC_Start_DMA(hadc, (uint32_t*)badc.idma.BufferADC, ADC_CONVERTED_CHANNELS) != HAL_OK){
-					return ADC_Error;
-				}
+		if(owner->config.dmaCircular == 0){ // DMA in normal mode stops after whole buffer | restarting
+			if(ADC_StartDMA(owner) != HAL_OK){
+				return ADC_Error;
 			}
 		}
 
@@ -139,16 +279,16 @@ ADC_StatusTypeDef ADC_ReadChannel(ADC_HandleTypeDef* hadc, uint8_t channel, uint
 /**
   * @brief ADC Basic function of returning value
   * 	   if calculating value's logic is different, then developer should implement his function
-  * @param  hadc    - pointer to ADC handle
+  * @param  ctx     - pointer to ADC context
   * @param  channel - number of channel to be read
   * @param  retval  - pointer to variable, whose contains return value
   * @retval status  - HAL status if Reading channel went successfully
   */
-__weak ADC_StatusTypeDef  ADC_GetValue(ADC_HandleTypeDef* hadc, float max, uint8_t channel, float * retval){
+__weak ADC_StatusTypeDef  ADC_GetValue(ADC_ContextTypeDef* ctx, float max, uint8_t channel, float * retval){
 	uint16_t binary_value = 0;
-	uint32_t adc_resolutiion = __ADC_RESOLUTION(hadc);
+	uint32_t adc_resolutiion = ctx->config.resolution;
 
-	if(ADC_ReadChannel(hadc, channel, &binary_value) != ADC_OK){
+	if(ADC_ReadChannel(ctx, channel, &binary_value) != ADC_OK){
 		return ADC_Error;
 	}
 
@@ -159,139 +299,1624 @@ __weak ADC_StatusTypeDef  ADC_GetValue(ADC_HandleTypeDef* hadc, float max, uint8
 
 }
 
-/*
- * @brief Empty implementation of callback function | If body of this function should does some functionalities, then implementation is required
- */
-void               HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc){
+/**
+  * @brief ADC Reading all channels function | values of all ranks are taken in one pass, all from the same completed half
+  * 	   Every value is filtered according to filter mode of its channel
+  * 	   Values are stored in rank order, channel of every rank is available in ctx->cadc.channels
+  * @param  ctx     - pointer to ADC context
+  * @param  raw     - array of averaged binary values, can be NULL
+  * @param  scaled  - array of values scaled to max, can be NULL
+  * @param  max     - value corresponding to full scale of ADC
+  * @param  size    - size of arrays, must fit all converted ranks
+  * @retval status  - ADC status, ADC_Busy if not enough measures were converted yet
+  */
+ADC_StatusTypeDef ADC_ReadAllChannels(ADC_ContextTypeDef* ctx, uint16_t* raw, float* scaled, float max, uint8_t size){
+
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	uint8_t  ranks            = ctx->config.convertedChannels;
+	float    factor           = max / (float)ctx->config.resolution;      // one division for all ranks
+	uint32_t sequence;
+	uint16_t value;
+
+	if(owner->config.mode == ADC_MODE_POLLING){ // sums are maintained by DMA callbacks only
+		return ADC_DMA_NotEnabled;
+	}
+
+	if(size < ranks){
+		return ADC_Error;
+	}
+
+	if(ctx->aadc.filled < ADC_AVERAGED_MEASURES){ // ring is not filled yet | counted per completed block, so lazy ranks are ready as well
+		return ADC_Busy;
+	}
+
+	do{
+		sequence = owner->pp.sequence;
+
+		for(uint8_t rank = 0; rank < ranks; ++rank){
+			value = ADC_FilteredValue(ctx, rank);
+
+			if(raw != NULL){
+				raw[rank] = value;
+			}
+
+			if(scaled != NULL){
+				scaled[rank] = (float)value * factor;
+			}
+		}
+
+	}while(sequence != owner->pp.sequence); // DMA callback updated sums meanwhile, repeating for consistent set
+
+	if(owner->config.dmaCircular == 0){ // DMA in normal mode stops after whole buffer | restarting
+		if(ADC_StartDMA(owner) != HAL_OK){
+			return ADC_Error;
+		}
+	}
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC fixed-point scale setting function | scale of channel is precomputed here, so reading needs no division
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  max     - value corresponding to full scale of ADC, in fixed-point format (ADC_TO_FIXED)
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetScaleFixed(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t max){
+	uint8_t rank;
+
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
 
-	UNUSED(hadc); // unused variable to avoid warnings
+	ctx->fixed[rank].max = max;
+	ADC_UpdateFixedScale(ctx, rank);
 
+	return ADC_OK;
 }
 
 /**
-  * @brief ADC channels configuration function | auto detects ranks and overwrite ADC_ChannelsTypeDef object's content
-  * @param  hadc    - pointer to ADC handle
+  * @brief ADC fixed-point function of returning value | integer-only alternative of ADC_GetValue
+  * 	   Full scale is 1.0 until ADC_SetScaleFixed is called for channel
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel to be read
+  * @param  retval  - pointer to value in fixed-point format, ADC_FIXED_Q fractional bits
   * @retval status  - ADC status
   */
-ADC_StatusTypeDef  ADC_Config_GetRanksOfChannels(ADC_HandleTypeDef* hadc){
+ADC_StatusTypeDef ADC_GetValueFixed(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t* retval){
+	uint16_t binary_value = 0;
+	ADC_StatusTypeDef status;
+
+	status = ADC_ReadChannel(ctx, channel, &binary_value);
+
+	if(status != ADC_OK){
+		return status;
+	}
+
+	// rank is valid, channel was resolved by ADC_ReadChannel
+	*retval = ADC_FixedValue(ctx, ctx->cadc.rankOfChannel[channel], binary_value);
 
-	uint32_t numberOfConversions = ((hadc->Instance->SQR1 >> 20) & 0xF) + 1;
+	return ADC_OK;
+}
 
+/**
+  * @brief ADC boxcar filter setting function | channel returns running average of ADC_AVERAGED_MEASURES samples (default)
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetFilterBoxcar(ADC_ContextTypeDef* ctx, uint8_t channel){
+	uint8_t rank;
 
-	if(numberOfConversions > 16 || numberOfConversions < 0){
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
 		return ADC_Error;
 	}
 
+	ctx->filters.mode[rank] = ADC_FILTER_BOXCAR;
 
-	ADC_CONVERTED_CHANNELS = numberOfConversions;
+#if ADC_USE_EMA
+	ADC_Ema_Config(&ctx->filters.ema[rank], 0);
+#endif
+#if ADC_USE_NOTCH
+	ADC_Notch_Config(&ctx->filters.notch[rank], 0);
+#endif
 
-	for(int i = 0; i < numberOfConversions; ++i){
+	return ADC_OK;
+}
 
-		if(i > 6 && i < 13){
-			cadc.channels[i] = ((hadc->Instance->SQR1 >> (5 * (i - 6))) & 0x1F);
-		}else if(i > 12){
-			cadc.channels[i] = ((hadc->Instance->SQR2 >> (5 * (i - 2 * 6))) & 0x1F);
-		}else{
-			cadc.channels[i] = ((hadc->Instance->SQR3 >> (5 * i)) & 0x1F);
-		}
+#if ADC_USE_EMA
+/**
+  * @brief ADC exponential moving average setting function | channel returns EMA with time constant of 2^shift samples
+  * 	   Filter keeps one accumulator per channel and can be read at any time
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  shift   - k, time constant of 2^k samples, 1 - ADC_EMA_MAX_SHIFT
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetFilterEMA(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t shift){
+	uint8_t rank;
 
-		if(cadc.channels[i] > 16 || cadc.channels[i] < 0){
-			return ADC_Error;
-		}
+	if(shift == 0 || shift > ADC_EMA_MAX_SHIFT || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ADC_Ema_Config(&ctx->filters.ema[rank], shift);
+	ctx->filters.mode[rank] = ADC_FILTER_EMA;
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_NOTCH
+/**
+  * @brief ADC notch design function | tunes notches of all channels to ripple frequency and its harmonics at sample rate of channels
+  * 	   Sample rate of channel is conversion rate of whole sequence. Must be repeated when sample rate changes
+  * @param  ctx        - pointer to ADC context
+  * @param  sampleRate - sample rate of every channel in Hz, 0 - rate of timer-triggered acquisition
+  * @param  frequency  - ripple frequency in Hz, e.g. 40
+  * @param  harmonics  - number of notched harmonics, 1 - ADC_NOTCH_MAX_HARMONICS
+  * @retval status     - ADC status, ADC_Error if ripple frequency is above Nyquist frequency
+  */
+ADC_StatusTypeDef ADC_SetNotch(ADC_ContextTypeDef* ctx, float sampleRate, float frequency, uint8_t harmonics){
+
+	if(sampleRate == 0.0f){
+		sampleRate = ctx->config.sampleRate;
+	}
+
+	if(sampleRate <= 0.0f || frequency <= 0.0f || harmonics == 0 || harmonics > ADC_NOTCH_MAX_HARMONICS){
+		return ADC_Error;
+	}
+
+	if(ADC_Notch_Design(&ctx->filters.notchBank, sampleRate, frequency, harmonics) == 0){
+		return ADC_Error;
+	}
 
+	// histories of old design are not valid
+	for(uint8_t rank = 0; rank < ADC_SEQUENCE_LENGTH; ++rank){
+		ADC_Notch_Config(&ctx->filters.notch[rank], ctx->filters.notch[rank].enabled);
 	}
 
 	return ADC_OK;
 }
 
 /**
-  * @brief ADC channels' ranks return function. In case of wanting channel's rank, function returns it
-  * @param  hadc    - pointer to ADC handle
+  * @brief ADC notch filter setting function | channel returns samples with ripple designed by ADC_SetNotch removed
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @retval status  - ADC status, ADC_Error if notch is not designed
+  */
+ADC_StatusTypeDef ADC_SetFilterNotch(ADC_ContextTypeDef* ctx, uint8_t channel){
+	uint8_t rank;
+
+	if(ctx->filters.notchBank.sections == 0 || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ADC_Notch_Config(&ctx->filters.notch[rank], 1);
+	ctx->filters.mode[rank] = ADC_FILTER_NOTCH;
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_MEDIAN
+/**
+  * @brief ADC median prefilter setting function | every sample of channel is replaced by trimmed mean of its window,
+  * 	   so single-sample spikes do not reach running average and other filters
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  size    - window of 3, 5, 7 or 9 samples, 0 disables prefilter
+  * @param  trim    - samples dropped at each end of sorted window, (size - 1) / 2 gives median, 1 drops min and max
   * @retval status  - ADC status
   */
-ADC_StatusTypeDef  ADC_GetRank(ADC_ChannelsTypeDef *cadc, uint8_t channel, uint8_t* rank){
+ADC_StatusTypeDef ADC_SetMedian(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t size, uint8_t trim){
+	uint8_t rank;
+
+	if((size != 0 && (size > ADC_MEDIAN_MAX_SIZE || (size & 1U) == 0 || size < 3 || 2U * trim >= size))
+			|| ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
 
-	for(int i = 0 ; i <= ADC_MAX_CHANNELS; ++i ){
-		if(cadc->channels[i] == channel){
-			*rank = (uint8_t)i;
+	ADC_Median_Config(&ctx->filters.median[rank], size, trim);
 
-			break;
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_STATS
+/**
+  * @brief ADC statistics window setting function | min, max, mean and peak-to-peak of channel are collected over window
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  length  - window length in samples of channel, 1 - ADC_STATS_MAX_WINDOW, 0 disables statistics
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetStatsWindow(ADC_ContextTypeDef* ctx, uint8_t channel, uint32_t length){
+	uint8_t rank;
+
+	if(length > ADC_STATS_MAX_WINDOW || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ADC_Stats_Config(&ctx->filters.stats[rank], length);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC statistics reading function | consistent snapshot of all ranks' last completed windows, nothing is re-scanned
+  * 	   Snapshot is repeated if DMA callback published new windows meanwhile
+  * @param  ctx     - pointer to ADC context
+  * @param  stats   - array of returned statistics, indexed by rank, ranks without statistics return zeros
+  * @param  size    - number of elements of stats, at least number of converted channels
+  * @retval status  - ADC status, ADC_Busy if no window is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadAllStats(ADC_ContextTypeDef* ctx, ADC_StatsSnapshotTypeDef* stats, uint8_t size){
+
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	uint8_t  ranks            = ctx->config.convertedChannels;
+	uint32_t windows;
+	uint32_t sequence;
+
+	if(owner->config.mode == ADC_MODE_POLLING){ // statistics are maintained by DMA callbacks only
+		return ADC_DMA_NotEnabled;
+	}
+
+	if(size < ranks){
+		return ADC_Error;
+	}
+
+	do{
+		sequence = owner->pp.sequence;
+		windows  = 0;
+
+		for(uint8_t rank = 0; rank < ranks; ++rank){
+			ADC_Stats_Read(&ctx->filters.stats[rank], &stats[rank]);
+			windows |= stats[rank].windows;
 		}
+
+	}while(sequence != owner->pp.sequence); // DMA callback published windows meanwhile, repeating for consistent set
+
+	return (windows == 0) ? ADC_Busy : ADC_OK;
+}
+
+/**
+  * @brief ADC statistics reading function of channel | consistent snapshot of last completed window
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  stats   - pointer to returned statistics
+  * @retval status  - ADC status, ADC_Busy if no window is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadStats(ADC_ContextTypeDef* ctx, uint8_t channel, ADC_StatsSnapshotTypeDef* stats){
+
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	uint32_t sequence;
+	uint8_t  rank;
+
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK || ctx->filters.stats[rank].length == 0){
+		return ADC_Error;
+	}
+
+	if(owner->config.mode == ADC_MODE_POLLING){ // statistics are maintained by DMA callbacks only
+		return ADC_DMA_NotEnabled;
 	}
 
-	if(*rank > 16 || *rank < 0){
+	do{
+		sequence = owner->pp.sequence;
+		ADC_Stats_Read(&ctx->filters.stats[rank], stats);
+	}while(sequence != owner->pp.sequence); // DMA callback published window meanwhile
+
+	return (stats->windows == 0) ? ADC_Busy : ADC_OK;
+}
+#endif
+
+#if ADC_USE_POWER
+/**
+  * @brief ADC power pair setting function | RMS of both channels and their active power are computed in DMA callbacks
+  * 	   Values are in LSB, RMS * max / resolution gives physical value, power needs product of both factors
+  * @param  ctx            - pointer to ADC context
+  * @param  pair           - index of pair, 0 - ADC_POWER_MAX_PAIRS - 1
+  * @param  channelVoltage - number of voltage channel
+  * @param  channelCurrent - number of current channel
+  * @param  offsetVoltage  - zero of voltage channel in LSB, e.g. half of resolution
+  * @param  offsetCurrent  - zero of current channel in LSB
+  * @param  length         - samples per update, e.g. whole number of periods, 0 disables pair
+  * @retval status         - ADC status
+  */
+ADC_StatusTypeDef ADC_SetPowerPair(ADC_ContextTypeDef* ctx, uint8_t pair, uint8_t channelVoltage, uint8_t channelCurrent,
+								   uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length){
+	uint8_t rankVoltage;
+	uint8_t rankCurrent;
+
+	if(pair >= ADC_POWER_MAX_PAIRS
+			|| ADC_GetRank(&ctx->cadc, channelVoltage, &rankVoltage) != ADC_OK
+			|| ADC_GetRank(&ctx->cadc, channelCurrent, &rankCurrent) != ADC_OK){
 		return ADC_Error;
 	}
 
+	ADC_Power_Config(&ctx->filters.power[pair], rankVoltage, rankCurrent, 0, offsetVoltage, offsetCurrent, length);
+
 	return ADC_OK;
 }
 
 /**
-  * @brief ADC averaging function. ADC's channels' values oscillate in 40 Hz, function averages measures from exact number of conversions.
-  * 	   Macro: ADC_AVERAGED_MEASURES stores information about number of latest conversions to be measured
-  * @param  hadc    - pointer to ADC handle
-  * @param  badc    - ADC buffer, which stores converted values
-  * @param  retval  - pointer to returning value
-  * @retval status  - ADC status
+  * @brief ADC dual power pair setting function | voltage converted by master and current by slave at the same instants,
+  * 	   pair is processed after both blocks of completed half. Values as of ADC_SetPowerPair, ADC_ReadPower is called with master context
+  * @param  ctx            - pointer to ADC context of master in dual mode, slave linked by ADC_InitSlave
+  * @param  pair           - index of pair, 0 - ADC_POWER_MAX_PAIRS - 1
+  * @param  channelVoltage - number of voltage channel of master
+  * @param  channelCurrent - number of current channel of slave
+  * @param  offsetVoltage  - zero of voltage channel in LSB, e.g. half of resolution
+  * @param  offsetCurrent  - zero of current channel in LSB
+  * @param  length         - samples per update, e.g. whole number of periods, 0 disables pair
+  * @retval status         - ADC status, ADC_Error if context is not master of dual mode
   */
-ADC_StatusTypeDef ADC_Averaging(ADC_HandleTypeDef* hadc, ADC_BufferTypeDef* badc, uint8_t channel , uint16_t* retval){
-	uint64_t sum = 0; // sum of averaged values
-	uint8_t rank;     // channel rank
+ADC_StatusTypeDef ADC_SetPowerPairDual(ADC_ContextTypeDef* ctx, uint8_t pair, uint8_t channelVoltage, uint8_t channelCurrent,
+									   uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length){
+	uint8_t rankVoltage;
+	uint8_t rankCurrent;
+
+	if(pair >= ADC_POWER_MAX_PAIRS || ctx->slave == NULL || ctx->config.mode != ADC_MODE_MULTIMODE
+			|| ADC_GetRank(&ctx->cadc, channelVoltage, &rankVoltage) != ADC_OK
+			|| ADC_GetRank(&ctx->slave->cadc, channelCurrent, &rankCurrent) != ADC_OK){
+		return ADC_Error;
+	}
 
-	// Getting channel rank
-	if(ADC_GetRank(&cadc, channel, &rank) != ADC_OK){
-		return ADC_Error;;
+	ADC_Power_Config(&ctx->filters.power[pair], rankVoltage, rankCurrent, 1, offsetVoltage, offsetCurrent, length);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC power reading function | consistent RMS and active power of last completed window of pair
+  * @param  ctx     - pointer to ADC context
+  * @param  pair    - index of pair
+  * @param  power   - pointer to returned values
+  * @retval status  - ADC status, ADC_Busy if no window is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadPower(ADC_ContextTypeDef* ctx, uint8_t pair, ADC_PowerSnapshotTypeDef* power){
+
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	uint32_t sequence;
+
+	if(pair >= ADC_POWER_MAX_PAIRS || ctx->filters.power[pair].length == 0){
+		return ADC_Error;
 	}
 
-	if(__ADC_IS_DMA_MULTIMODE(hadc) != 0){ // ADC in dual mode
-		if(sizeof(badc->idma.BufferADC)/sizeof(badc->idma.BufferADC[0]) < ADC_AVERAGED_MEASURES){
+	if(owner->config.mode == ADC_MODE_POLLING){ // power is computed by DMA callbacks only
+		return ADC_DMA_NotEnabled;
+	}
+
+	do{
+		sequence = owner->pp.sequence;
+		ADC_Power_Read(&ctx->filters.power[pair], power);
+	}while(sequence != owner->pp.sequence); // DMA callback published window meanwhile
+
+	return (power->updates == 0) ? ADC_Busy : ADC_OK;
+}
+#endif
+
+#if ADC_USE_GOERTZEL
+/**
+  * @brief ADC tone bin setting function | attaches Goertzel bin to channel, frequency is rounded to nearest bin of length-point DFT
+  * @param  ctx        - pointer to ADC context
+  * @param  bin        - index of bin, 0 - ADC_GOERTZEL_MAX_BINS - 1
+  * @param  channel    - number of channel
+  * @param  sampleRate - sample rate of channel in Hz, 0 - rate of timer-triggered acquisition
+  * @param  frequency  - measured frequency in Hz, e.g. 40
+  * @param  length     - samples per measurement, resolution is sampleRate / length, 0 disables bin
+  * @param  actual     - pointer to returned frequency of bin, can be NULL
+  * @retval status     - ADC status, ADC_Error if frequency rounds to DC or Nyquist frequency
+  */
+ADC_StatusTypeDef ADC_SetToneBin(ADC_ContextTypeDef* ctx, uint8_t bin, uint8_t channel, float sampleRate, float frequency, uint32_t length, float* actual){
+	uint32_t k = 0;
+	uint8_t rank;
+
+	if(bin >= ADC_GOERTZEL_MAX_BINS || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	if(sampleRate == 0.0f){
+		sampleRate = ctx->config.sampleRate;
+	}
+
+	if(length != 0){
+		if(sampleRate <= 0.0f || frequency <= 0.0f){
 			return ADC_Error;
 		}
 
+		k = (uint32_t)(frequency * (float)length / sampleRate + 0.5f);
 
-	}else{								   // ADC in independent mode
-		if(sizeof(badc->ddma.BufferMultiMode)/sizeof(badc->ddma.BufferMultiMode) < ADC_AVERAGED_MEASURES){
+		if(k == 0 || 2 * k >= length){
 			return ADC_Error;
 		}
 
-		if(hadc->Instance == ADC1){
+		if(actual != NULL){
+			*actual = (float)k * sampleRate / (float)length;
+		}
+	}
 
-			// Extracting ADC1 values from dual mode buffer
-			for(int  i = 0 ; i <= ADC_BUFF_SIZE ; ++i){
-				badc->ddma.BufferADC_Master[i] = ((badc->ddma.BufferMultiMode[i] >> 16) & 0xFF);
-			}
+	ADC_Goertzel_Config(&ctx->filters.goertzel[bin], rank, k, length);
 
-		}else if(hadc->Instance == ADC2){
+	return ADC_OK;
+}
 
-			// Extracting ADC2 values from dual mode buffer
-			for(int  i = 0 ; i <= ADC_BUFF_SIZE ; ++i){
-				badc->ddma.BufferADC_Slave[i] = (badc->ddma.BufferMultiMode[i] & 0xFF);
-			}
+/**
+  * @brief ADC tone reading function | amplitude of bin's frequency in last completed measurement
+  * @param  ctx       - pointer to ADC context
+  * @param  bin       - index of bin
+  * @param  amplitude - pointer to returned amplitude of sine in LSB
+  * @retval status    - ADC status, ADC_Busy if no measurement is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadTone(ADC_ContextTypeDef* ctx, uint8_t bin, float* amplitude){
 
-		}
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	ADC_GoertzelTypeDef* g;
+	uint32_t sequence;
+	uint32_t updates;
+	uint64_t power;
 
+	if(bin >= ADC_GOERTZEL_MAX_BINS || ctx->filters.goertzel[bin].length == 0){
+		return ADC_Error;
+	}
 
+	if(owner->config.mode == ADC_MODE_POLLING){ // bins are computed by DMA callbacks only
+		return ADC_DMA_NotEnabled;
 	}
 
+	g = &ctx->filters.goertzel[bin];
 
-	int16_t id = 0; // current position of averaged value
-	for( int i = 0; i <= ADC_AVERAGED_MEASURES; ++i){
-		id = (i * ADC_AVERAGED_MEASURES + rank);
+	do{
+		sequence = owner->pp.sequence;
+		power    = g->power;
+		updates  = g->updates;
+	}while(sequence != owner->pp.sequence); // DMA callback published measurement meanwhile
 
-		// adding to sum variable next value correlated to current channel
-		sum += ((__ADC_IS_DMA_MULTIMODE(hadc) == 0)
-					 ? badc->idma.BufferADC[id] 							 // adding value of ADC in independent mode
-				      :((hadc->Instance == ADC1)
-					 ? badc->ddma.BufferADC_Master[id]
-	                  : badc->ddma.BufferADC_Slave[id]));                   // adding value of ADC in dual mode | checking instance
+	if(updates == 0){
+		return ADC_Busy;
 	}
 
-	*retval = (sum / ADC_AVERAGED_MEASURES); // averaging by dividing sum with number of averaged conversions
+	*amplitude = 2.0f * sqrtf((float)power) / (float)g->length; // |X(k)| of sine is amplitude * length / 2
 
-	return HAL_OK;
+	return ADC_OK;
 }
+#endif
 
+#if ADC_USE_WATCHDOG
+/**
+  * @brief ADC software watchdog setting function | channel is checked in every DMA callback, state changes after debounce samples beyond threshold
+  * 	   Reaction time is at most one DMA half plus debounce samples
+  * @param  ctx        - pointer to ADC context
+  * @param  channel    - number of channel
+  * @param  low        - low threshold in LSB, 0 disables low side
+  * @param  high       - high threshold in LSB, 0xFFFF disables high side
+  * @param  hysteresis - hysteresis of thresholds in LSB
+  * @param  debounce   - consecutive samples needed to change state, 0 disables watchdog
+  * @retval status     - ADC status
+  */
+ADC_StatusTypeDef ADC_SetWatchdog(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t low, uint16_t high, uint16_t hysteresis, uint16_t debounce){
+	uint8_t rank;
 
+	if(low > high || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
 
+	ADC_Watchdog_Config(&ctx->filters.watchdog[rank], low, high, hysteresis, debounce);
 
+	return ADC_OK;
+}
 
+/**
+  * @brief ADC watchdog callback registering function | callback is called from DMA callback, so it should only react, e.g. switch off PWM
+  * @param  ctx      - pointer to ADC context
+  * @param  callback - application callback, NULL unregisters it
+  * @retval status   - ADC status
+  */
+ADC_StatusTypeDef ADC_SetWatchdogCallback(ADC_ContextTypeDef* ctx, ADC_WatchdogCallbackTypeDef callback){
+
+	ctx->filters.watchdogHandler = NULL; // handler disabled while callback is rewritten
+	ctx->watchdogCallback        = callback;
+	ctx->filters.watchdogOwner   = ctx;
+
+	if(callback != NULL){
+		ctx->filters.watchdogHandler = ADC_WatchdogDispatch;
+	}
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC watchdog state reading function
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  state   - pointer to returned state
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_GetWatchdogState(ADC_ContextTypeDef* ctx, uint8_t channel, ADC_WatchdogStateTypeDef* state){
+	uint8_t rank;
+
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	*state = (ADC_WatchdogStateTypeDef)ctx->filters.watchdog[rank].state;
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_TIMER_TRIGGER
+/**
+  * @brief ADC timer trigger setting function | conversions of whole sequence are started by timer TRGO instead of continuous mode,
+  * 	   so sample rate of every channel is exact and known to filters. Prescaler and period of timer are computed here
+  * 	   In dual mode function is called for master, slave follows master's trigger. Interleaved ADCs are paced by their delay, not by trigger,
+  * 	   so sample rate cannot be set there and function is rejected
+  * @param  ctx        - pointer to ADC context of master or independent ADC
+  * @param  htim       - pointer to initialized handle of trigger timer
+  * @param  trigger    - HAL external trigger of ADC matching timer TRGO, e.g. ADC_EXTERNALTRIGCONV_T3_TRGO
+  * @param  sampleRate - requested sample rate of every channel in Hz, ADC_GetSampleRate returns rate actually set
+  * @retval status     - ADC status, ADC_Error if rate cannot be reached by timer or mode is interleaved
+  */
+ADC_StatusTypeDef ADC_SetTimerTrigger(ADC_ContextTypeDef* ctx, TIM_HandleTypeDef* htim, uint32_t trigger, uint32_t sampleRate){
+	TIM_MasterConfigTypeDef master = {0};
+	uint32_t clock = ADC_TimerClock(htim->Instance);
+	uint32_t ticks;
+	uint32_t prescaler;
+	uint32_t period;
+
+	if(ctx->master != NULL || ctx->config.interleaved != 0 || sampleRate == 0){
+		return ADC_Error;
+	}
+
+	ticks     = (clock + sampleRate / 2U) / sampleRate; // timer clocks per sample
+	prescaler = (ticks - 1U) / 0x10000U;                // smallest prescaler, so period has best resolution
+	period    = (ticks + (prescaler + 1U) / 2U) / (prescaler + 1U);
+
+	if(ticks < 2U || prescaler > 0xFFFFU){
+		return ADC_Error;
+	}
+
+	if(HAL_TIM_Base_Stop(htim) != HAL_OK || ADC_Stop(ctx) != HAL_OK){
+		return ADC_Error;
+	}
+
+	htim->Init.Prescaler     = prescaler;
+	htim->Init.Period        = period - 1U;
+	htim->Init.CounterMode   = TIM_COUNTERMODE_UP;
+	htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+
+	master.MasterOutputTrigger = TIM_TRGO_UPDATE;
+	master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+
+	if(HAL_TIM_Base_Init(htim) != HAL_OK || HAL_TIMEx_MasterConfigSynchronization(htim, &master) != HAL_OK){
+		return ADC_Error;
+	}
+
+	// single sequence per trigger, handle is kept consistent with registers
+	__ADC_SET_EXTERNAL_TRIGGER(ctx->hadc, trigger);
+	ctx->hadc->Init.ContinuousConvMode = DISABLE;
+	ctx->hadc->Init.ExternalTrigConv   = trigger;
+
+	ctx->config.timerClock   = clock;
+	ctx->config.samplePeriod = (prescaler + 1U) * period;
+	ctx->config.sampleRate   = (float)clock / (float)ctx->config.samplePeriod;
+
+	if(ctx->slave != NULL){ // slave converts together with master
+		ctx->slave->config.timerClock   = ctx->config.timerClock;
+		ctx->slave->config.samplePeriod = ctx->config.samplePeriod;
+		ctx->slave->config.sampleRate   = ctx->config.sampleRate;
+	}
+
+#if ADC_USE_CAPTURE
+	ADC_CapturePeriod(ctx);
+
+	if(ctx->slave != NULL){
+		ADC_CapturePeriod(ctx->slave);
+	}
+#endif
+
+	if(ADC_Start(ctx) != HAL_OK || HAL_TIM_Base_Start(htim) != HAL_OK){
+		return ADC_Error;
+	}
+
+	return ADC_OK;
+}
+#endif
+
+/**
+  * @brief ADC sample rate returning function | exact rate of every channel in timer-triggered acquisition
+  * @param  ctx        - pointer to ADC context
+  * @param  sampleRate - pointer to returned sample rate in Hz
+  * @retval status     - ADC status, ADC_Error if rate is unknown (continuous mode)
+  */
+ADC_StatusTypeDef ADC_GetSampleRate(ADC_ContextTypeDef* ctx, float* sampleRate){
+
+	if(ctx->config.samplePeriod == 0){
+		return ADC_Error;
+	}
+
+	*sampleRate = ctx->config.sampleRate;
+
+	return ADC_OK;
+}
+
+#if ADC_USE_INJECTED
+/**
+  * @brief ADC injected group setting function | few critical channels are converted on external trigger, e.g. timer compare at PWM center,
+  * 	   interrupting regular DMA scan, which keeps running. Group is started with JEOC interrupt (ADC IRQ must be enabled)
+  * 	   Should be called once, before trigger timer is started
+  * @param  ctx          - pointer to ADC context
+  * @param  channels     - array of injected channel numbers (0 - 18), in order of ranks
+  * @param  count        - length of injected sequence, 1 - ADC_INJECTED_RANKS
+  * @param  samplingTime - HAL sampling time of injected channels, e.g. ADC_SAMPLETIME_7CYCLES_5
+  * @param  trigger      - HAL injected trigger, e.g. ADC_EXTERNALTRIGINJECCONV_T1_CC4, ADC_INJECTED_SOFTWARE_START
+  * @param  callback     - application callback called from ADC interrupt after every injected sequence, can be NULL
+  * @retval status       - ADC status
+  */
+ADC_StatusTypeDef ADC_SetInjected(ADC_ContextTypeDef* ctx, const uint8_t* channels, uint8_t count, uint32_t samplingTime, uint32_t trigger,
+								  ADC_InjectedCallbackTypeDef callback){
+	ADC_InjectionConfTypeDef config = {0};
+
+	if(count == 0 || count > ADC_INJECTED_RANKS){
+		return ADC_Error;
+	}
+
+	ctx->injected.count = 0; // interrupt is not dispatched while group is rewritten
+
+	for(uint8_t rank = 0; rank < count; ++rank){
+
+		if(channels[rank] >= ADC_CHANNEL_IDS){
+			return ADC_Error;
+		}
+
+		config.InjectedChannel               = __ADC_CHANNEL_FROM_ID(channels[rank]);
+		config.InjectedRank                  = __ADC_INJECTED_RANK(rank);
+		config.InjectedSamplingTime          = samplingTime;
+		config.InjectedOffset                = 0;
+		config.InjectedNbrOfConversion       = count;
+		config.InjectedDiscontinuousConvMode = DISABLE;
+		config.AutoInjectedConv              = DISABLE;
+		config.ExternalTrigInjecConv         = trigger;
+		__ADC_INJECTED_CONFIG_FAMILY(&config);
+
+		if(HAL_ADCEx_InjectedConfigChannel(ctx->hadc, &config) != HAL_OK){
+			return ADC_Error;
+		}
+
+		ctx->injected.channels[rank] = channels[rank];
+	}
+
+	ctx->injected.callback = callback;
+	ctx->injected.sequence = 0;
+	ctx->injected.count    = count;
+
+	if(HAL_ADCEx_InjectedStart_IT(ctx->hadc) != HAL_OK){
+		return ADC_Error;
+	}
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC injected channel reading function | value is read directly from JDRx register of channel's rank
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of injected channel
+  * @param  retval  - pointer to returned value
+  * @retval status  - ADC status, ADC_Busy if no injected sequence is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadInjected(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t* retval){
+
+	for(uint8_t rank = 0; rank < ctx->injected.count; ++rank){
+
+		if(ctx->injected.channels[rank] != channel){
+			continue;
+		}
+
+		if(ctx->injected.sequence == 0){
+			return ADC_Busy;
+		}
+
+		*retval = (uint16_t)__ADC_INJECTED_DATA(ctx->hadc, rank);
+
+		return ADC_OK;
+	}
+
+	return ADC_Error;
+}
+
+/**
+  * @brief ADC injected group reading function | values of all injected ranks from one sequence
+  * 	   Called from injected callback it returns values of sequence just completed
+  * @param  ctx     - pointer to ADC context
+  * @param  values  - array of returned values, indexed by injected rank, at least length of injected sequence
+  * @retval status  - ADC status, ADC_Busy if no injected sequence is completed yet
+  */
+ADC_StatusTypeDef ADC_ReadAllInjected(ADC_ContextTypeDef* ctx, uint16_t* values){
+	uint32_t sequence;
+
+	if(ctx->injected.count == 0){
+		return ADC_Error;
+	}
+
+	do{
+		sequence = ctx->injected.sequence;
+
+		for(uint8_t rank = 0; rank < ctx->injected.count; ++rank){
+			values[rank] = (uint16_t)__ADC_INJECTED_DATA(ctx->hadc, rank);
+		}
+
+	}while(sequence != ctx->injected.sequence); // next injected sequence completed meanwhile, repeating for consistent set
+
+	return (sequence == 0) ? ADC_Busy : ADC_OK;
+}
+#endif
+
+#if ADC_USE_CALIBRATION
+/**
+  * @brief ADC calibration setting function | ADC_GetValueFixed returns ((raw - offset) * gain) mapped by table or scale of ADC_SetScaleFixed
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  offset  - raw offset in LSB
+  * @param  gain    - raw gain in Q ADC_CALIBRATION_GAIN_Q, (1 << ADC_CALIBRATION_GAIN_Q) - no correction
+  * @param  table   - table defined by ADC_CALIBRATION_TABLE, at least 2 points, NULL - linear scale
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetCalibration(ADC_ContextTypeDef* ctx, uint8_t channel, int32_t offset, int32_t gain, const ADC_CalibrationTableTypeDef* table){
+	uint8_t rank;
+
+	if(gain <= 0 || (table != NULL && (table->count < 2 || table->stepShift > 16))
+			|| ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ctx->fixed[rank].offset = offset;
+	ctx->fixed[rank].gain   = gain;
+	ctx->fixed[rank].table  = table;
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_CAPTURE
+/**
+  * @brief ADC capture setting function | records decimated raw samples of channels with timestamps into ring, ring is armed
+  * 	   Every entry is stamped with time of its scan at rate of ADC_SetTimerTrigger, in continuous mode with time of its DMA half
+  * @param  ctx           - pointer to ADC context
+  * @param  channels      - array of recorded channels
+  * @param  count         - number of recorded channels, 1 - ADC_CAPTURE_CHANNELS, 0 disables capture
+  * @param  decimation    - every decimation-th scan is recorded, at least 1
+  * @param  preTrigger    - entries exported before trigger
+  * @param  postTrigger   - entries recorded after trigger, preTrigger + postTrigger <= ADC_CAPTURE_DEPTH
+  * @param  freezeOnFault - 1 - watchdog event (ADC_USE_WATCHDOG) triggers capture
+  * @retval status        - ADC status
+  */
+ADC_StatusTypeDef ADC_SetCapture(ADC_ContextTypeDef* ctx, const uint8_t* channels, uint8_t count, uint16_t decimation,
+								 uint16_t preTrigger, uint16_t postTrigger, uint8_t freezeOnFault){
+	ADC_CaptureTypeDef* capture = &ctx->filters.capture;
+	uint8_t rank[ADC_CAPTURE_CHANNELS];
+
+	if(count > ADC_CAPTURE_CHANNELS || decimation == 0 || (uint32_t)preTrigger + postTrigger > ADC_CAPTURE_DEPTH){
+		return ADC_Error;
+	}
+
+	for(uint8_t i = 0; i < count; ++i){
+		if(ADC_GetRank(&ctx->cadc, channels[i], &rank[i]) != ADC_OK){
+			return ADC_Error;
+		}
+	}
+
+	capture->state    = ADC_CAPTURE_IDLE; // recording stopped while capture is rewritten
+	capture->channels = count;
+
+	for(uint8_t i = 0; i < count; ++i){
+		capture->rank[i] = rank[i];
+	}
+
+	capture->decimation    = decimation;
+	capture->preTrigger    = preTrigger;
+	capture->postTrigger   = postTrigger;
+	capture->freezeOnFault = freezeOnFault;
+
+	ADC_CapturePeriod(ctx);
+	ADC_Capture_Arm(capture);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC capture trigger function | e.g. from fault handler, ring freezes after post-trigger entries
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - ADC status, ADC_Error if capture is not armed
+  */
+ADC_StatusTypeDef ADC_TriggerCapture(ADC_ContextTypeDef* ctx){
+
+	if(ctx->filters.capture.state != ADC_CAPTURE_ARMED){
+		return ADC_Error;
+	}
+
+	ADC_Capture_Trigger(&ctx->filters.capture);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC capture arming function | empties ring and restarts recording after export
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - ADC status, ADC_Error if capture is not set
+  */
+ADC_StatusTypeDef ADC_ArmCapture(ADC_ContextTypeDef* ctx){
+
+	if(ctx->filters.capture.channels == 0){
+		return ADC_Error;
+	}
+
+	ADC_Capture_Arm(&ctx->filters.capture);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC capture export function | frozen ring as one contiguous array from oldest to newest entry, e.g. for CAN or UART dump
+  * 	   Entries stay valid until ADC_ArmCapture
+  * @param  ctx     - pointer to ADC context
+  * @param  entries - pointer to returned address of first entry
+  * @param  count   - pointer to returned number of entries
+  * @retval status  - ADC status, ADC_Busy if capture is not frozen yet
+  */
+ADC_StatusTypeDef ADC_GetCapture(ADC_ContextTypeDef* ctx, const ADC_CaptureEntryTypeDef** entries, uint16_t* count){
+
+	if(ctx->filters.capture.state != ADC_CAPTURE_FROZEN){
+		return (ctx->filters.capture.state == ADC_CAPTURE_IDLE) ? ADC_Error : ADC_Busy;
+	}
+
+	*count = ADC_Capture_Export(&ctx->filters.capture, entries);
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_SUBSCRIPTION
+/**
+  * @brief ADC subscription setting function | rarely read channels (e.g. board temperature) can be left out of DMA callbacks,
+  * 	   so callback cost is proportional to channels which matter. Channel with divider n is processed in every n-th block,
+  * 	   its stages see every n-th block of samples. Unsubscribed channel is averaged from newest samples on read, in boxcar mode regardless of filter mode
+  * 	   Watchdog, capture, power and Goertzel stages process every block of their channels
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  divider - 0 - unsubscribed (computed on read), 1 - every block (default), n - every n-th block
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetSubscription(ADC_ContextTypeDef* ctx, uint8_t channel, uint16_t divider){
+	uint8_t rank;
+
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	if(divider == 0){
+		ctx->filters.lazy |= 1UL << rank;
+
+		return ADC_OK;
+	}
+
+	// rate is set before rank is subscribed, first block after subscription is processed
+	ctx->filters.divider[rank]   = divider;
+	ctx->filters.countdown[rank] = 0;
+	ctx->filters.lazy           &= ~(1UL << rank);
+
+	return ADC_OK;
+}
+#endif
+
+#if ADC_USE_OVERSAMPLING
+/**
+  * @brief ADC oversampling setting function | 4^shift samples of channel are summed into one value with shift extra bits
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel
+  * @param  shift   - n of 4^n oversampling, 0 disables oversampling of channel
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef ADC_SetOversampling(ADC_ContextTypeDef* ctx, uint8_t channel, uint8_t shift){
+	uint8_t rank;
+
+	if(shift > ADC_OVERSAMPLING_MAX_SHIFT || ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ADC_Oversampling_Config(&ctx->filters.oversampling[rank], shift);
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC Reading oversampled channel function | returns last decimated value, updated every 4^shift samples
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel to be read
+  * @param  retval  - pointer to decimated value
+  * @param  bits    - pointer to effective resolution of value in bits, can be NULL
+  * @retval status  - ADC status, ADC_Busy if first decimation period is not completed yet
+  */
+ADC_StatusTypeDef ADC_ReadOversampled(ADC_ContextTypeDef* ctx, uint8_t channel, uint32_t* retval, uint8_t* bits){
+	ADC_OversamplingTypeDef* os;
+	uint8_t rank;
+
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+	os = &ctx->filters.oversampling[rank];
+
+	if(os->shift == 0){ // oversampling not enabled for channel
+		return ADC_Error;
+	}
+
+	if(os->outputs == 0){
+		return ADC_Busy;
+	}
+
+	*retval = os->output;
+
+	if(bits != NULL){
+		*bits = ctx->config.resolutionBits + os->shift;
+	}
+
+	return ADC_OK;
+}
+#endif
+
+/*
+ * @brief DMA half transfer callback | first half of ping-pong buffer is completed, DMA continues with second half
+ */
+void               HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc){
+
+	ADC_ContextTypeDef* ctx = ADC_GetContext(hadc);
+
+	if(ctx == NULL){ // callback of ADC not handled by driver
+		return;
+	}
+
+	ADC_ProcessHalf(ctx, 0);
+
+	ctx->pp.isReady = 1;
+	ctx->pp.sequence++;
+
+}
+
+/*
+ * @brief DMA transfer complete callback | second half of ping-pong buffer is completed, DMA wraps to first half
+ */
+void               HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc){
+
+	ADC_ContextTypeDef* ctx = ADC_GetContext(hadc);
+
+	if(ctx == NULL){ // callback of ADC not handled by driver
+		return;
+	}
+
+	ADC_ProcessHalf(ctx, 1);
+
+	ctx->pp.isReady = 1;
+	ctx->pp.sequence++;
+
+}
+
+#if ADC_USE_INJECTED
+/*
+ * @brief Injected conversion complete callback | JDRx hold values of injected sequence until next trigger
+ */
+void               HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc){
+
+	ADC_ContextTypeDef* ctx = ADC_GetContext(hadc);
+
+	if(ctx == NULL || ctx->injected.count == 0){ // injected group not handled by driver
+		return;
+	}
+
+	ctx->injected.sequence++;
+
+	if(ctx->injected.callback != NULL){
+		ctx->injected.callback(ctx);
+	}
+
+}
+#endif
+
+/**
+  * @brief ADC channels configuration function | auto detects ranks and overwrite ADC_ChannelsTypeDef object's content
+  * 	   Builds inverse channel to rank table and bitmask of configured channels, so reads never scan ranks
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - ADC status
+  */
+ADC_StatusTypeDef  ADC_Config_GetRanksOfChannels(ADC_ContextTypeDef* ctx){
+
+	ADC_ChannelsTypeDef* cadc = &ctx->cadc;
+	uint32_t numberOfConversions = __ADC_SEQUENCE_LENGTH(ctx->hadc);
+
+
+	if(numberOfConversions > ADC_SEQUENCE_LENGTH){ // DMA buffer and sums are sized for ADC_SEQUENCE_LENGTH ranks
+		return ADC_Error;
+	}
+
+
+	ctx->config.convertedChannels = (uint8_t)numberOfConversions;
+	cadc->mask                    = 0;
+
+	for(uint32_t i = 0; i < numberOfConversions; ++i){
+
+		cadc->channels[i] = (uint8_t)__ADC_SEQUENCE_CHANNEL(ctx->hadc, i);
+
+		if(cadc->channels[i] >= ADC_CHANNEL_IDS){
+			cadc->mask = 0;
+			return ADC_Error;
+		}
+
+		// channel converted in several ranks is resolved to its first rank
+		if((cadc->mask & (1UL << cadc->channels[i])) == 0){
+			cadc->rankOfChannel[cadc->channels[i]] = (uint8_t)i;
+			cadc->mask |= (1UL << cadc->channels[i]);
+		}
+
+	}
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC channels' ranks return function. In case of wanting channel's rank, function returns it
+  * @param  cadc    - pointer to ranks configuration
+  * @param  channel - number of channel
+  * @param  rank    - pointer to returned rank
+  * @retval status  - ADC status, ADC_Error if channel is not configured
+  */
+ADC_StatusTypeDef  ADC_GetRank(ADC_ChannelsTypeDef *cadc, uint8_t channel, uint8_t* rank){
+
+	if(channel >= ADC_CHANNEL_IDS || (cadc->mask & (1UL << channel)) == 0){
+		return ADC_Error;
+	}
+
+	*rank = cadc->rankOfChannel[channel];
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC averaging function. ADC's channels' values oscillate in 40 Hz, function averages measures from exact number of conversions.
+  * 	   Macro: ADC_AVERAGED_MEASURES stores information about number of latest conversions to be measured
+  * 	   Sums are maintained in DMA callbacks, so reading is a single shift of channel's running sum
+  * @param  ctx     - pointer to ADC context
+  * @param  channel - number of channel to be read
+  * @param  retval  - pointer to returning value
+  * @retval status  - ADC status, ADC_Busy if not enough measures were converted yet
+  */
+ADC_StatusTypeDef ADC_Averaging(ADC_ContextTypeDef* ctx, uint8_t channel , uint16_t* retval){
+	uint8_t rank; // channel rank
+
+	// Getting channel rank
+	if(ADC_GetRank(&ctx->cadc, channel, &rank) != ADC_OK){
+		return ADC_Error;
+	}
+
+#if ADC_USE_SUBSCRIPTION
+	if(ctx->filters.lazy & (1UL << rank)){ // rank is not processed in DMA callbacks, one completed block is enough
+		if(ctx->lastBlock == NULL){
+			return ADC_Busy;
+		}
+
+		*retval = ADC_LazyValue(ctx, rank);
+
+		return ADC_OK;
+	}
+#endif
+
+	if(ctx->aadc.filled < ADC_AVERAGED_MEASURES){ // ring is not filled yet
+		return ADC_Busy;
+	}
+
+	*retval = (uint16_t)(ctx->aadc.sum[rank] >> ADC_AVERAGED_SHIFT); // averaging by shifting sum with number of averaged conversions
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC configuration snapshot | resolves ranks, mode, resolution and DMA circularity from registers once
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - ADC status
+  */
+static ADC_StatusTypeDef ADC_Config_Snapshot(ADC_ContextTypeDef* ctx){
+	ADC_HandleTypeDef* hadc = ctx->hadc;
+
+	if(ADC_Config_GetRanksOfChannels(ctx) != ADC_OK){
+		return ADC_Error;
+	}
+
+	ctx->config.resolution     = (uint16_t)__ADC_RESOLUTION(hadc);
+	ctx->config.resolutionBits = 0;
+
+	while((1UL << ctx->config.resolutionBits) <= ctx->config.resolution){
+		ctx->config.resolutionBits++;
+	}
+
+	// resolution could change, fixed-point scales are recomputed
+	for(uint8_t rank = 0; rank < ADC_SEQUENCE_LENGTH; ++rank){
+		ADC_UpdateFixedScale(ctx, rank);
+	}
+	ctx->config.dmaCircular    = 0;
+	ctx->config.interleaved    = 0;
+	ctx->config.hwOversampling = (uint8_t)__ADC_IS_HW_OVERSAMPLING(hadc);
+
+	if(ctx->master != NULL){ 					// slave in dual mode | DMA is owned by master
+		ctx->config.mode = ADC_MODE_MULTIMODE;
+	}else if(__ADC_IS_DMA_ENABLED(hadc) == 0){ 	// DMA disabled
+		ctx->config.mode = ADC_MODE_POLLING;
+	}else{
+		ctx->config.mode        = (__ADC_IS_DMA_MULTIMODE(hadc) != 0) ? ADC_MODE_MULTIMODE : ADC_MODE_INDEPENDENT;
+		ctx->config.dmaCircular = (uint8_t)(__ADC_DMA_MODE(hadc) != 0);
+		ctx->config.interleaved = (uint8_t)__ADC_INTERLEAVED(hadc);
+	}
+
+	if(ctx->config.interleaved != 0){ // ADCs convert the same single channel one after another
+		ctx->config.mode = ADC_MODE_INTERLEAVED;
+
+		if(ctx->config.convertedChannels != 1 || __ADC_IS_DMA_PACKED(hadc) == 0){ // halfwords of one word are consecutive samples only in DMA mode 2
+			return ADC_Error;
+		}
+	}
+
+	if(ctx->master == NULL && __ADC_MODE(hadc) != 0){ // continuous mode, sample rate depends on sampling times
+		ctx->config.sampleRate   = 0.0f;
+		ctx->config.samplePeriod = 0;
+	}
+
+#if !ADC_USE_MULTIMODE
+	if(ctx->config.mode == ADC_MODE_MULTIMODE || ctx->config.mode == ADC_MODE_INTERLEAVED){ // buffer of dual mode is not reserved
+		return ADC_Error;
+	}
+#endif
+
+	return ADC_OK;
+}
+
+/**
+  * @brief ADC start | resets ping-pong state and running sums, then starts conversions according to snapshot
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - HAL status
+  */
+static HAL_StatusTypeDef ADC_Start(ADC_ContextTypeDef* ctx){
+
+	// resetting ping-pong state, no half is valid until first callback
+	ctx->pp.isReady  = 0;
+	ctx->pp.sequence = 0;
+
+	// resetting running sums and processing stages, averages are invalid until rings are filled
+	ADC_ResetAveraging(&ctx->aadc);
+	ADC_Filters_Reset(&ctx->filters);
+
+#if ADC_USE_SUBSCRIPTION
+	ctx->lastBlock = NULL; // lazy ranks are invalid until first completed block
+#endif
+
+	if(ctx->slave != NULL){
+		ADC_ResetAveraging(&ctx->slave->aadc);
+		ADC_Filters_Reset(&ctx->slave->filters);
+#if ADC_USE_SUBSCRIPTION
+		ctx->slave->lastBlock = NULL;
+#endif
+	}
+
+	if(ctx->config.mode == ADC_MODE_POLLING){
+
+		// check if ADC is not started
+		if(__ADC_IS_CONV_STARTED(ctx->hadc) == 0){
+			return HAL_ADC_Start(ctx->hadc);
+		}
+
+		return HAL_OK;
+	}
+
+	if(ctx->badc == NULL){ // DMA enabled, but no buffer given to ADC_Init
+		return HAL_ERROR;
+	}
+
+	return ADC_StartDMA(ctx);
+}
+
+/**
+  * @brief ADC stop | stops conversions according to snapshot
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - HAL status
+  */
+static HAL_StatusTypeDef ADC_Stop(ADC_ContextTypeDef* ctx){
+
+	switch(ctx->config.mode){
+#if ADC_USE_MULTIMODE
+		case ADC_MODE_MULTIMODE:
+		case ADC_MODE_INTERLEAVED:
+			return HAL_ADCEx_MultiModeStop_DMA(ctx->hadc);
+#endif
+		case ADC_MODE_INDEPENDENT:
+			return HAL_ADC_Stop_DMA(ctx->hadc);
+
+		default:
+			return HAL_ADC_Stop(ctx->hadc);
+	}
+}
+
+/**
+  * @brief ADC fixed-point scales reset | full scale of every rank is 1.0
+  * @param  ctx     - pointer to ADC context
+  */
+static void ADC_ResetFixedScale(ADC_ContextTypeDef* ctx){
+
+	for(uint8_t rank = 0; rank < ADC_SEQUENCE_LENGTH; ++rank){
+		ctx->fixed[rank].max   = ADC_TO_FIXED(1);
+		ctx->fixed[rank].scale = 0;
+#if ADC_USE_CALIBRATION
+		ctx->fixed[rank].offset = 0;
+		ctx->fixed[rank].gain   = (int32_t)(1UL << ADC_CALIBRATION_GAIN_Q);
+		ctx->fixed[rank].table  = NULL;
+#endif
+	}
+}
+
+/**
+  * @brief ADC fixed-point scale precomputation | scale keeps resolutionBits of extra precision
+  * @param  ctx     - pointer to ADC context
+  * @param  rank    - rank to be updated
+  */
+static void ADC_UpdateFixedScale(ADC_ContextTypeDef* ctx, uint8_t rank){
+
+	if(ctx->config.resolution == 0){ // snapshot not taken yet
+		return;
+	}
+
+	ctx->fixed[rank].scale = (int32_t)(((int64_t)ctx->fixed[rank].max << ctx->config.resolutionBits) / ctx->config.resolution);
+}
+
+#if ADC_USE_TIMER_TRIGGER
+/**
+  * @brief ADC timer clock | timers run at twice APB clock when APB prescaler is not 1
+  * @param  instance - timer peripheral
+  * @retval clock    - timer clock in Hz
+  */
+static uint32_t ADC_TimerClock(TIM_TypeDef* instance){
+	uint32_t hclk = HAL_RCC_GetHCLKFreq();
+	uint32_t pclk = ((uintptr_t)instance >= APB2PERIPH_BASE) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+	return (pclk == hclk) ? pclk : 2U * pclk;
+}
+#endif
+
+#if ADC_USE_CAPTURE
+/**
+  * @brief ADC capture scan period | timestamp ticks between scans of timer-triggered acquisition,
+  * 	   0 in continuous mode, where entries of one DMA half share its timestamp
+  * @param  ctx     - pointer to ADC context
+  */
+static void ADC_CapturePeriod(ADC_ContextTypeDef* ctx){
+	float period = 0.0f;
+
+	if(ctx->config.sampleRate > 0.0f){
+		period = (float)ADC_CAPTURE_TIMESTAMP_HZ * (float)(1UL << ADC_CAPTURE_PERIOD_Q) / ctx->config.sampleRate;
+	}
+
+	ctx->filters.capture.scanPeriod = (period < 4294967295.0f) ? (uint32_t)(period + 0.5f) : 0xFFFFFFFFU; // saturated below one scan per 2^24 ticks
+}
+#endif
+
+#if ADC_USE_HW_OVERSAMPLING
+/**
+  * @brief ADC hardware oversampler setting | ratio of ADC_AVERAGED_MEASURES conversions shifted by ADC_AVERAGED_SHIFT, so every sample is an average
+  * 	   Oversampler can be changed only with conversions stopped, otherwise configuration of application is kept. No-op in families without oversampler
+  * @param  hadc    - pointer to ADC handle
+  */
+static void ADC_HwOversampling(ADC_HandleTypeDef* hadc){
+
+	if(ADC_AVERAGED_SHIFT > 0 && __ADC_IS_CONV_STARTED(hadc) == 0){
+		__ADC_SET_HW_OVERSAMPLING(hadc, ADC_AVERAGED_SHIFT);
+	}
+}
+#endif
+
+/**
+  * @brief ADC fixed-point value of rank | calibration (if enabled) and scaling of raw value, integer only
+  * 	   Table value is interpolated between two neighbouring points, no log or division per sample
+  * @param  ctx     - pointer to ADC context
+  * @param  rank    - rank of channel
+  * @param  raw     - raw value
+  * @retval value   - value in fixed-point format
+  */
+static int32_t ADC_FixedValue(ADC_ContextTypeDef* ctx, uint8_t rank, uint16_t raw){
+	ADC_FixedScaleTypeDef* fixed = &ctx->fixed[rank];
+	int32_t value                = raw;
+
+#if ADC_USE_CALIBRATION
+	const ADC_CalibrationTableTypeDef* table = fixed->table;
+
+	value = (int32_t)(((int64_t)(value - fixed->offset) * fixed->gain + (1LL << (ADC_CALIBRATION_GAIN_Q - 1))) >> ADC_CALIBRATION_GAIN_Q); // rounded to nearest LSB
+
+	if(value < 0){ // corrected value is limited to range of ADC
+		value = 0;
+	}else if(value > (int32_t)ctx->config.resolution){
+		value = ctx->config.resolution;
+	}
+
+	if(table != NULL){
+		uint32_t index = (uint32_t)value >> table->stepShift;
+		int32_t  frac  = value & (int32_t)((1UL << table->stepShift) - 1);
+
+		if(index >= table->count - 1U){ // above last point
+			return table->points[table->count - 1U];
+		}
+
+		return table->points[index] + (int32_t)(((int64_t)(table->points[index + 1] - table->points[index]) * frac) >> table->stepShift);
+	}
+#endif
+
+	return (int32_t)(((int64_t)value * fixed->scale + (1LL << (ctx->config.resolutionBits - 1U))) >> ctx->config.resolutionBits); // rounded, error stays below 1 LSB
+}
+
+/**
+  * @brief ADC filtered value of rank | value according to filter mode of rank, constant time
+  * @param  ctx     - pointer to ADC context
+  * @param  rank    - rank of channel
+  * @retval value   - filtered value
+  */
+static uint16_t ADC_FilteredValue(ADC_ContextTypeDef* ctx, uint8_t rank){
+
+#if ADC_USE_SUBSCRIPTION
+	if(ctx->filters.lazy & (1UL << rank)){ // rank is not processed in DMA callbacks
+		return ADC_LazyValue(ctx, rank);
+	}
+#endif
+
+	switch(ctx->filters.mode[rank]){
+#if ADC_USE_EMA
+		case ADC_FILTER_EMA:
+			return (uint16_t)(ctx->filters.ema[rank].acc >> ctx->filters.ema[rank].shift);
+#endif
+#if ADC_USE_NOTCH
+		case ADC_FILTER_NOTCH:
+			return ADC_Notch_Read(&ctx->filters.notch[rank]);
+#endif
+		default:
+			return (uint16_t)(ctx->aadc.sum[rank] >> ADC_AVERAGED_SHIFT);
+	}
+}
+
+#if ADC_USE_SUBSCRIPTION
+/**
+  * @brief ADC value of lazy rank | average of newest ADC_AVERAGED_MEASURES samples of last completed block, computed on read
+  * 	   Block is stable until DMA completes the other half, so reading is repeated if callback came meanwhile
+  * @param  ctx     - pointer to ADC context
+  * @param  rank    - rank of channel
+  * @retval value   - averaged value
+  */
+static uint16_t ADC_LazyValue(ADC_ContextTypeDef* ctx, uint8_t rank){
+	ADC_ContextTypeDef* owner = (ctx->master != NULL) ? ctx->master : ctx; // context owning DMA
+	uint8_t  ranks            = ctx->config.convertedChannels;
+	uint32_t sequence;
+	uint16_t value;
+
+	do{
+		sequence = owner->pp.sequence;
+
+		const uint16_t* newest = &ctx->lastBlock[(ctx->lastScans - 1U) * ranks + rank];
+
+		if(ctx->config.hwOversampling && (ADC_Filters_SampleRanks(&ctx->filters, ranks) & (1UL << rank)) == 0U){ // samples are averaged by hardware
+			value = *newest;
+		}else{
+			value = (uint16_t)(ADC_Kernel_Sum(newest - (ADC_AVERAGED_MEASURES - 1U) * ranks, ranks, ADC_AVERAGED_MEASURES) >> ADC_AVERAGED_SHIFT);
+		}
+
+	}while(sequence != owner->pp.sequence);
+
+	return value;
+}
+#endif
+
+#if ADC_USE_WATCHDOG
+/**
+  * @brief ADC watchdog event dispatch | translates rank of stage into channel of application callback
+  * @param  owner   - pointer to ADC context
+  * @param  rank    - rank of channel
+  * @param  state   - new state
+  * @param  value   - sample which changed state
+  */
+static void ADC_WatchdogDispatch(void* owner, uint8_t rank, ADC_WatchdogStateTypeDef state, uint16_t value){
+	ADC_ContextTypeDef* ctx = (ADC_ContextTypeDef*)owner;
+
+	if(ctx->watchdogCallback != NULL){
+		ctx->watchdogCallback(ctx, ctx->cadc.channels[rank], state, value);
+	}
+}
+#endif
+
+/**
+  * @brief ADC DMA start | starts ping-pong transfer of context owning DMA
+  * @param  ctx     - pointer to ADC context
+  * @retval status  - HAL status
+  */
+static HAL_StatusTypeDef ADC_StartDMA(ADC_ContextTypeDef* ctx){
+
+#if ADC_USE_MULTIMODE
+	// check if multimode is enabled
+	if(ctx->config.mode == ADC_MODE_MULTIMODE || ctx->config.mode == ADC_MODE_INTERLEAVED){
+
+		// starting DMA with ADC in dual mode
+		return HAL_ADCEx_MultiModeStart_DMA(ctx->hadc, ctx->badc->ddma.BufferMultiMode, ADC_DMA_LENGTH(ctx));
+	}
+#endif
+
+	// starting DMA with ADC in Independent mode
+	return HAL_ADC_Start_DMA(ctx->hadc, (uint32_t*)ctx->badc->idma.BufferADC, ADC_DMA_LENGTH(ctx));
+}
+
+/**
+  * @brief ADC running sums reset | averages are invalid until ring is filled again
+  * @param  avg     - running sums to be reset
+  */
+static void ADC_ResetAveraging(ADC_AveragingTypeDef* avg){
+
+	for(int rank = 0; rank < ADC_SEQUENCE_LENGTH; ++rank){
+		avg->sum[rank] = 0;
+
+		for(uint32_t j = 0; j < ADC_AVERAGED_MEASURES; ++j){
+			avg->ring[rank][j] = 0;
+		}
+	}
+
+	avg->position = 0;
+	avg->filled   = 0;
+}
+
+/**
+  * @brief ADC processing of completed half of ping-pong buffer, called from DMA callbacks
+  * 	   In dual mode packed words are split first, then measures of every ADC are accumulated from dedicated storage
+  * 	   In interleaved mode packed halfwords are samples of one channel in time order, so they are accumulated in place
+  * @param  ctx     - pointer to ADC context, which owns DMA
+  * @param  half    - completed half: 0 - first half, 1 - second half
+  */
+static void ADC_ProcessHalf(ADC_ContextTypeDef* ctx, uint8_t half){
+	uint32_t length = ADC_DMA_HALF_SCANS * ctx->config.convertedChannels; // measures of one ADC in half
+
+#if ADC_USE_MULTIMODE
+	if(ctx->config.mode == ADC_MODE_MULTIMODE){ // ADC in dual mode | master and slave in one word
+
+		ADC_Deinterleave(ctx, &ctx->badc->ddma.BufferMultiMode[half * length], length);
+
+		ADC_AccumulateBlock(ctx, ctx->block, ADC_DMA_HALF_SCANS);
+
+		if(ctx->slave != NULL){
+			ADC_AccumulateBlock(ctx->slave, ctx->slave->block, ADC_DMA_HALF_SCANS);
+
+			// stages pairing master and slave channels see both blocks prefiltered
+			ADC_Filters_ProcessDualBlock(&ctx->filters, ctx->block, ctx->config.convertedChannels,
+										 ctx->slave->block, ctx->slave->config.convertedChannels, ADC_DMA_HALF_SCANS);
+		}
+
+		return;
+	}
+
+	if(ctx->config.mode == ADC_MODE_INTERLEAVED){ // ADCs interleaved on one channel | every word holds two consecutive samples
+		uint16_t* samples = &ctx->badc->ddma.BufferInterleaved[2U * half * length];
+
+		if(__ADC_INTERLEAVED_HIGH_FIRST){ // restoring time order, older sample of word is in bits 31:16
+			for(uint32_t i = 0; i < 2U * length; i += 2U){
+				uint16_t older = samples[i + 1U];
+
+				samples[i + 1U] = samples[i];
+				samples[i]      = older;
+			}
+		}
+
+		ADC_AccumulateBlock(ctx, samples, 2U * ADC_DMA_HALF_SCANS);
+
+		return;
+	}
+#endif
+
+	ADC_AccumulateBlock(ctx, &ctx->badc->idma.BufferADC[half * length], ADC_DMA_HALF_SCANS); // ADC in independent mode
+}
+
+#if ADC_USE_MULTIMODE
+/**
+  * @brief ADC dual mode split | master measures are in bits 15:0, slave measures in bits 31:16 of every word
+  * @param  ctx     - pointer to master ADC context
+  * @param  packed  - first word of completed half
+  * @param  length  - number of words in half
+  */
+static void ADC_Deinterleave(ADC_ContextTypeDef* ctx, const uint32_t* packed, uint32_t length){
+	uint16_t* master = ctx->block;
+	uint16_t* slave  = (ctx->slave != NULL) ? ctx->slave->block : NULL;
+
+	for(uint32_t i = 0; i < length; ++i){
+		master[i] = (uint16_t)(packed[i] & 0xFFFFU);
+	}
+
+	if(slave == NULL){
+		return;
+	}
+
+	for(uint32_t i = 0; i < length; ++i){
+		slave[i]  = (uint16_t)(packed[i] >> 16);
+	}
+}
+#endif
+
+/**
+  * @brief ADC accumulation of block of measures | every sample is added once to running sum of its rank
+  * 	   With hardware oversampler samples are already averaged, running sum is replaced by newest sample instead,
+  * 	   except ranks with median, statistics or watchdog, which keep software running sums of oversampled samples
+  * 	   With subscriptions only ranks scheduled for this block are accumulated and processed
+  * 	   Prefilters replace samples of block in place before accumulation, block is not written by DMA at that time
+  * @param  ctx     - pointer to ADC context, whose measures are in block
+  * @param  block   - scans interleaved by ranks
+  * @param  scans   - number of scans in block | ADC_DMA_HALF_SCANS, twice as many in interleaved mode
+  */
+static void ADC_AccumulateBlock(ADC_ContextTypeDef* ctx, uint16_t* block, uint32_t scans){
+	uint8_t ranks = ctx->config.convertedChannels; // number of ranks in scan
+
+#if ADC_USE_SUBSCRIPTION
+	ctx->lastBlock = block;
+	ctx->lastScans = scans;
+
+	ADC_Filters_Schedule(&ctx->filters, ranks); // ranks processed in this block, lazy ranks are computed on read
+#endif
+
+	uint32_t active   = ADC_FILTERS_ACTIVE(&ctx->filters);
+	uint32_t averaged = active; // ranks with software running sums
+
+	ADC_Filters_PrefilterBlock(&ctx->filters, block, ranks, scans);
+
+	if(ctx->config.hwOversampling){ // samples are averaged by hardware, newest scan is scaled as full running sum
+		averaged = active & ADC_Filters_SampleRanks(&ctx->filters, ranks); // ranks with median, statistics or watchdog keep software sums
+
+		for(int rank = 0; rank < ranks; ++rank){
+			if((active & ~averaged) & (1UL << rank)){
+				ctx->aadc.sum[rank] = (uint32_t)block[(scans - 1U) * ranks + rank] << ADC_AVERAGED_SHIFT;
+			}
+		}
+	}
+
+	if(averaged != 0U){
+		for(uint32_t scan = 0; scan < scans; ++scan){
+
+			for(int rank = 0; rank < ranks; ++rank){
+				if(averaged & (1UL << rank)){ // running sums of ranks scheduled in this block
+					ADC_AccumulateSample(&ctx->aadc, rank, block[scan * ranks + rank]);
+				}
+			}
+
+			// moving ring position after whole scan, every rank got one measure
+			ADC_AdvanceAveraging(&ctx->aadc);
+		}
+	}
+
+	// counted per completed block, so context with all ranks lazy (nothing averaged) becomes ready as well
+	ctx->aadc.filled = (ctx->aadc.filled + scans >= ADC_AVERAGED_MEASURES) ? ADC_AVERAGED_MEASURES : (uint8_t)(ctx->aadc.filled + scans);
+
+	ADC_Filters_ProcessBlock(&ctx->filters, block, ranks, scans);
+}
+
+/**
+  * @brief ADC running sum update | replaces oldest measure of rank with new one
+  * @param  avg     - running sums to be updated
+  * @param  rank    - rank of measured channel
+  * @param  sample  - converted value
+  */
+static void ADC_AccumulateSample(ADC_AveragingTypeDef* avg, uint8_t rank, uint16_t sample){
+	uint16_t* oldest = &avg->ring[rank][avg->position];
+
+	avg->sum[rank] = avg->sum[rank] + sample - *oldest;
+	*oldest        = sample;
+}
+
+/**
+  * @brief ADC ring position update | called after every scan of all ranks, ring is counted as filled per block
+  * @param  avg     - running sums to be updated
+  */
+static void ADC_AdvanceAveraging(ADC_AveragingTypeDef* avg){
+
+	avg->position = (avg->position + 1) & (ADC_AVERAGED_MEASURES - 1);
+}
@@ -0,0 +1,1237 @@
+/**
+  ******************************************************************************
+  * @file      adc_filters.c
+  * @author    Bartosz Rychlicki
+  * @Title     Universal driver for ADC peripheral
+  * @brief     This file contains bodies of per-channel processing stages. All stages are called from DMA callbacks,
+  * 		   once per completed half, and cost fixed number of cycles per sample
+  ******************************************************************************
+  * @attention Stages do not validate ranks, parameters are validated by ADC driver
+  *
+  * Copyright (c) 2025 AGH Eko-Energy.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+
+
+#include "adc_filters.h"
+#include <math.h>
+
+#if ADC_USE_MEDIAN
+// Sorting networks of median windows | pairs of compared positions, optimal number of comparators
+static const uint8_t ADC_Network3[] = {0,1, 1,2, 0,1};
+static const uint8_t ADC_Network5[] = {0,1, 3,4, 2,4, 2,3, 0,3, 0,2, 1,4, 1,3, 1,2};
+static const uint8_t ADC_Network7[] = {0,6, 2,3, 4,5, 0,2, 1,4, 3,6, 0,1, 2,5, 3,4, 1,2, 4,6, 2,3, 4,5, 1,2, 3,4, 5,6};
+static const uint8_t ADC_Network9[] = {0,3, 1,7, 2,5, 4,8, 0,7, 2,4, 3,8, 5,6, 0,2, 1,3, 4,5, 7,8, 1,4, 3,6, 5,7, 0,1, 2,4, 3,5, 6,8,
+									   2,3, 4,5, 6,7, 1,2, 3,4, 5,6};
+
+// Branch-free compare and exchange | a gets smaller, b gets greater value
+#define ADC_SORT2(a, b)  do{ int32_t d = (b) - (a); d &= d >> 31; (a) += d; (b) -= d; }while(0)
+#endif
+
+/**
+  * @brief Processing stages reset | clears states of all ranks, configuration of stages is kept
+  * @param  filters - pointer to processing stages of ADC
+  */
+void ADC_Filters_Reset(ADC_FiltersTypeDef* filters){
+
+#if ADC_USE_POWER
+	for(uint8_t pair = 0; pair < ADC_POWER_MAX_PAIRS; ++pair){
+		ADC_PowerTypeDef* power = &filters->power[pair];
+		ADC_Power_Config(power, power->rankVoltage, power->rankCurrent, power->currentSlave, power->offsetVoltage, power->offsetCurrent, power->length);
+	}
+#endif
+
+#if ADC_USE_CAPTURE
+	if(filters->capture.state != ADC_CAPTURE_FROZEN){ // frozen capture is kept for export
+		ADC_Capture_Arm(&filters->capture);
+	}
+#endif
+
+#if ADC_USE_GOERTZEL
+	for(uint8_t i = 0; i < ADC_GOERTZEL_MAX_BINS; ++i){ // restarting blocks, coefficients are kept
+		ADC_GoertzelTypeDef* bin = &filters->goertzel[i];
+		uint32_t length = bin->length;
+
+		bin->length  = 0;
+		bin->s1      = 0;
+		bin->s2      = 0;
+		bin->count   = 0;
+		bin->power   = 0;
+		bin->updates = 0;
+		bin->length  = length;
+	}
+#endif
+
+	for(uint8_t rank = 0; rank < ADC_SEQUENCE_LENGTH; ++rank){
+#if ADC_USE_MEDIAN
+		ADC_Median_Config(&filters->median[rank], filters->median[rank].size, filters->median[rank].trim);
+#endif
+#if ADC_USE_OVERSAMPLING
+		ADC_Oversampling_Config(&filters->oversampling[rank], filters->oversampling[rank].shift);
+#endif
+#if ADC_USE_EMA
+		ADC_Ema_Config(&filters->ema[rank], filters->ema[rank].shift);
+#endif
+#if ADC_USE_STATS
+		ADC_Stats_Config(&filters->stats[rank], filters->stats[rank].length);
+#endif
+#if ADC_USE_WATCHDOG
+		filters->watchdog[rank].count = 0;
+		filters->watchdog[rank].state = ADC_WATCHDOG_NORMAL;
+#endif
+#if ADC_USE_NOTCH
+		ADC_Notch_Config(&filters->notch[rank], filters->notch[rank].enabled);
+#endif
+#if ADC_USE_SUBSCRIPTION
+		filters->countdown[rank] = 0; // first block is processed by every subscribed rank
+#endif
+	}
+
+	UNUSED(filters);
+}
+
+#if ADC_USE_SUBSCRIPTION
+/**
+  * @brief Scheduling of ranks of completed block | subscribed ranks are processed in every divider-th block, lazy ranks never
+  * 	   Capture, watchdog, power and Goertzel stages are configured explicitly and process every block regardless
+  * @param  filters - pointer to processing stages of ADC
+  * @param  ranks   - number of ranks in scan
+  */
+void ADC_Filters_Schedule(ADC_FiltersTypeDef* filters, uint8_t ranks){
+	uint32_t active = 0;
+
+	for(uint8_t rank = 0; rank < ranks; ++rank){
+
+		if(filters->lazy & (1UL << rank)){ // computed on read
+			continue;
+		}
+
+		if(filters->countdown[rank] == 0){
+			active                  |= 1UL << rank;
+			filters->countdown[rank] = (filters->divider[rank] > 1U) ? filters->divider[rank] - 1U : 0U;
+		}else{
+			filters->countdown[rank]--;
+		}
+	}
+
+	filters->active = active;
+}
+#endif
+
+/**
+  * @brief Ranks with stages working on single samples | median, statistics and watchdog of rank are configured
+  * 	   With hardware oversampler these ranks keep software running sums, so averaging of rank does not depend on oversampler
+  * @param  filters - pointer to processing stages of ADC
+  * @param  ranks   - number of ranks in scan
+  * @retval mask    - bitmask of ranks
+  */
+uint32_t ADC_Filters_SampleRanks(const ADC_FiltersTypeDef* filters, uint8_t ranks){
+	uint32_t mask = 0;
+
+	for(uint8_t rank = 0; rank < ranks; ++rank){
+		uint8_t attached = 0;
+
+#if ADC_USE_MEDIAN
+		attached |= (filters->median[rank].size != 0U);
+#endif
+#if ADC_USE_STATS
+		attached |= (filters->stats[rank].length != 0U);
+#endif
+#if ADC_USE_WATCHDOG
+		attached |= (filters->watchdog[rank].debounce != 0U);
+#endif
+
+		if(attached){
+			mask |= 1UL << rank;
+		}
+	}
+
+	UNUSED(filters);
+
+	return mask;
+}
+
+/**
+  * @brief Prefiltering of completed block | samples are replaced in place, before averaging and other stages see them
+  * @param  filters - pointer to processing stages of ADC
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  */
+void ADC_Filters_PrefilterBlock(ADC_FiltersTypeDef* filters, uint16_t* block, uint8_t ranks, uint32_t scans){
+
+#if ADC_USE_CAPTURE
+	ADC_Capture_ProcessBlock(&filters->capture, block, ranks, scans); // first, capture holds raw samples
+#endif
+
+#if ADC_USE_MEDIAN
+	ADC_Median_ProcessBlock(filters->median, block, ranks, scans, ADC_FILTERS_ACTIVE(filters));
+#endif
+
+	UNUSED(filters);
+	UNUSED(block);
+	UNUSED(ranks);
+	UNUSED(scans);
+}
+
+/**
+  * @brief Processing of completed block | every enabled stage walks block once
+  * @param  filters - pointer to processing stages of ADC
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  */
+void ADC_Filters_ProcessBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, uint32_t scans){
+
+#if ADC_USE_WATCHDOG
+	ADC_Watchdog_ProcessBlock(filters, block, ranks, scans); // first, fault reaction is not delayed by other stages
+#endif
+
+#if ADC_USE_OVERSAMPLING
+	ADC_Oversampling_ProcessBlock(filters->oversampling, block, ranks, scans, ADC_FILTERS_ACTIVE(filters));
+#endif
+
+#if ADC_USE_EMA
+	ADC_Ema_ProcessBlock(filters->ema, block, ranks, scans, ADC_FILTERS_ACTIVE(filters));
+#endif
+
+#if ADC_USE_STATS
+	ADC_Stats_ProcessBlock(filters->stats, block, ranks, scans, ADC_FILTERS_ACTIVE(filters));
+#endif
+
+#if ADC_USE_POWER
+	for(uint8_t pair = 0; pair < ADC_POWER_MAX_PAIRS; ++pair){
+		if(filters->power[pair].currentSlave == 0){ // pairs with slave channel wait for slave block
+			ADC_Power_ProcessBlock(&filters->power[pair], block, ranks, block, ranks, scans);
+		}
+	}
+#endif
+
+#if ADC_USE_GOERTZEL
+	for(uint8_t i = 0; i < ADC_GOERTZEL_MAX_BINS; ++i){
+		ADC_Goertzel_ProcessBlock(&filters->goertzel[i], block, ranks, scans);
+	}
+#endif
+
+#if ADC_USE_NOTCH
+	ADC_Notch_ProcessBlock(&filters->notchBank, filters->notch, block, ranks, scans, ADC_FILTERS_ACTIVE(filters));
+#endif
+
+	UNUSED(filters);
+	UNUSED(block);
+	UNUSED(ranks);
+	UNUSED(scans);
+}
+
+/**
+  * @brief Processing of completed blocks of dual mode | stages using channels of both ADCs, called after both blocks were processed
+  * @param  filters    - pointer to processing stages of master ADC
+  * @param  block      - scans of master interleaved by ranks
+  * @param  ranks      - number of ranks in scan of master
+  * @param  slaveBlock - scans of slave interleaved by ranks, converted simultaneously with master
+  * @param  slaveRanks - number of ranks in scan of slave
+  * @param  scans      - number of scans in both blocks
+  */
+void ADC_Filters_ProcessDualBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, const uint16_t* slaveBlock, uint8_t slaveRanks, uint32_t scans){
+
+#if ADC_USE_POWER
+	for(uint8_t pair = 0; pair < ADC_POWER_MAX_PAIRS; ++pair){
+		if(filters->power[pair].currentSlave != 0){ // voltage of master, current of slave
+			ADC_Power_ProcessBlock(&filters->power[pair], block, ranks, slaveBlock, slaveRanks, scans);
+		}
+	}
+#endif
+
+	UNUSED(filters);
+	UNUSED(block);
+	UNUSED(ranks);
+	UNUSED(slaveBlock);
+	UNUSED(slaveRanks);
+	UNUSED(scans);
+}
+
+/* Kernels ----------------------------------------------------------------------------- */
+/*  With DSP extension (Cortex-M4/M7) two samples are processed by one instruction. Samples are biased to signed halfwords
+ *  by flipping bit 15, so signed multiply-accumulate stays exact for full 16-bit range. Plain C loop is the bit-exact reference */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define ADC_KERNEL_PAIR(__SAMPLES__, __STRIDE__)  (__PKHBT((uint32_t)(__SAMPLES__)[0], (uint32_t)(__SAMPLES__)[(__STRIDE__)], 16))	// two samples in halfwords
+#define ADC_KERNEL_BIAS                           0x80008000U		// x - 32768 of both halfwords
+#define ADC_KERNEL_ONES                           0x00010001U		// multiplier summing both halfwords
+#endif
+
+/**
+  * @brief Sum of strided samples
+  * @param  samples - first sample
+  * @param  stride  - distance of consecutive samples | number of ranks in scan
+  * @param  count   - number of samples, up to 65536
+  * @retval sum     - sum of samples
+  */
+uint32_t ADC_Kernel_Sum(const uint16_t* samples, uint32_t stride, uint32_t count){
+	uint32_t sum = 0;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	uint32_t pairs  = count / 2U;
+	int64_t  biased = 0; // sum of biased samples
+
+	for(uint32_t i = 0; i < pairs; ++i, samples += 2U * stride){
+		biased = (int64_t)__SMLALD(ADC_KERNEL_PAIR(samples, stride) ^ ADC_KERNEL_BIAS, ADC_KERNEL_ONES, (uint64_t)biased);
+	}
+
+	sum    = (uint32_t)(biased + 32768 * (int64_t)(2U * pairs));
+	count -= 2U * pairs;
+#endif
+
+	for(; count > 0; --count, samples += stride){
+		sum += *samples;
+	}
+
+	return sum;
+}
+
+/**
+  * @brief Sum of squared deviations of strided samples from offset | offset 0 gives plain sum of squares
+  * @param  samples - first sample
+  * @param  stride  - distance of consecutive samples | number of ranks in scan
+  * @param  count   - number of samples, up to 65536
+  * @param  offset  - subtracted from every sample before squaring, e.g. zero of AC channel
+  * @retval sum     - sum of (sample - offset)^2
+  */
+uint64_t ADC_Kernel_SumSquares(const uint16_t* samples, uint32_t stride, uint32_t count, uint16_t offset){
+	uint64_t sum = 0;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	uint32_t pairs   = count / 2U;
+	int64_t  biased  = 0;                      // sum of biased samples b = x - 32768
+	int64_t  squares = 0;                      // sum of squared biased samples
+	int64_t  shift   = 32768 - (int32_t)offset; // x - offset = b + shift
+
+	for(uint32_t i = 0; i < pairs; ++i, samples += 2U * stride){
+		uint32_t pair = ADC_KERNEL_PAIR(samples, stride) ^ ADC_KERNEL_BIAS;
+
+		squares = (int64_t)__SMLALD(pair, pair, (uint64_t)squares);
+		biased  = (int64_t)__SMLALD(pair, ADC_KERNEL_ONES, (uint64_t)biased);
+	}
+
+	// (b + shift)^2 = b^2 + 2 * shift * b + shift^2
+	sum    = (uint64_t)(squares + 2 * shift * biased + (int64_t)(2U * pairs) * shift * shift);
+	count -= 2U * pairs;
+#endif
+
+	for(; count > 0; --count, samples += stride){
+		int32_t deviation = (int32_t)*samples - (int32_t)offset;
+
+		sum += (uint64_t)((int64_t)deviation * deviation); // |deviation| < 65536, square needs 64 bits
+	}
+
+	return sum;
+}
+
+/**
+  * @brief Sum, min and max of strided samples in one pass | min and max extend range given by caller, so windows can span several calls
+  * @param  samples - first sample
+  * @param  stride  - distance of consecutive samples | number of ranks in scan
+  * @param  count   - number of samples, up to 65536
+  * @param  min     - pointer to min, updated
+  * @param  max     - pointer to max, updated
+  * @retval sum     - sum of samples
+  */
+uint32_t ADC_Kernel_SumMinMax(const uint16_t* samples, uint32_t stride, uint32_t count, uint16_t* min, uint16_t* max){
+	uint32_t sum = 0;
+	uint16_t lo  = *min;
+	uint16_t hi  = *max;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	uint32_t pairs  = count / 2U;
+	int64_t  biased = 0;                   // sum of biased samples
+	uint32_t los    = lo * ADC_KERNEL_ONES; // min and max of both halfwords
+	uint32_t his    = hi * ADC_KERNEL_ONES;
+
+	for(uint32_t i = 0; i < pairs; ++i, samples += 2U * stride){
+		uint32_t pair = ADC_KERNEL_PAIR(samples, stride);
+
+		biased = (int64_t)__SMLALD(pair ^ ADC_KERNEL_BIAS, ADC_KERNEL_ONES, (uint64_t)biased);
+
+		(void)__USUB16(pair, his); // GE flags of halfwords, where pair >= his
+		his = __SEL(pair, his);
+
+		(void)__USUB16(pair, los); // GE flags of halfwords, where pair >= los
+		los = __SEL(los, pair);
+	}
+
+	sum    = (uint32_t)(biased + 32768 * (int64_t)(2U * pairs));
+	lo     = ((los & 0xFFFFU) < (los >> 16)) ? (uint16_t)los : (uint16_t)(los >> 16);
+	hi     = ((his & 0xFFFFU) > (his >> 16)) ? (uint16_t)his : (uint16_t)(his >> 16);
+	count -= 2U * pairs;
+#endif
+
+	for(; count > 0; --count, samples += stride){
+		sum += *samples;
+
+		if(*samples < lo){
+			lo = *samples;
+		}
+
+		if(*samples > hi){
+			hi = *samples;
+		}
+	}
+
+	*min = lo;
+	*max = hi;
+
+	return sum;
+}
+
+#if ADC_USE_MEDIAN
+/**
+  * @brief Median prefilter configuration | window is seeded by next sample
+  * @param  median  - pointer to median state of rank
+  * @param  size    - window of 3, 5, 7 or 9 samples, 0 disables stage
+  * @param  trim    - samples dropped at each end of sorted window, (size - 1) / 2 gives median
+  */
+void ADC_Median_Config(ADC_MedianTypeDef* median, uint8_t size, uint8_t trim){
+
+	median->size     = 0; // stage disabled while its state is rewritten
+	median->trim     = trim;
+	median->position = 0;
+	median->primed   = 0;
+	median->size     = size;
+}
+
+/**
+  * @brief Median prefilter of block | every sample is replaced by trimmed mean of its window, sorted by fixed network
+  * 	   Cost per sample depends only on window size
+  * @param  median  - array of median states, indexed by rank
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  * @param  active  - bitmask of ranks processed in this block
+  */
+void ADC_Median_ProcessBlock(ADC_MedianTypeDef* median, uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active){
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++median){
+		if((active & (1UL << rank)) == 0){ // rank is not scheduled in this block
+			continue;
+		}
+
+		uint8_t size = median->size;
+		const uint8_t* network;
+		uint8_t pairs;
+
+		switch(size){
+			case 3: network = ADC_Network3; pairs = sizeof(ADC_Network3) / 2; break;
+			case 5: network = ADC_Network5; pairs = sizeof(ADC_Network5) / 2; break;
+			case 7: network = ADC_Network7; pairs = sizeof(ADC_Network7) / 2; break;
+			case 9: network = ADC_Network9; pairs = sizeof(ADC_Network9) / 2; break;
+			default: continue; // stage disabled for rank
+		}
+
+		uint16_t* sample = &block[rank];
+		uint8_t first    = median->trim;
+		uint8_t last     = size - median->trim;
+
+		if(median->primed == 0){ // seeding window with first sample, no spike is emitted at start
+			for(uint8_t i = 0; i < size; ++i){
+				median->window[i] = *sample;
+			}
+			median->primed = 1;
+		}
+
+		for(uint32_t scan = 0; scan < scans; ++scan, sample += ranks){
+			int32_t v[ADC_MEDIAN_MAX_SIZE];
+			uint32_t sum = 0;
+
+			median->window[median->position] = *sample;
+			median->position = (median->position + 1 == size) ? 0 : median->position + 1;
+
+			for(uint8_t i = 0; i < size; ++i){
+				v[i] = median->window[i];
+			}
+
+			for(uint8_t i = 0; i < pairs; ++i){
+				ADC_SORT2(v[network[2 * i]], v[network[2 * i + 1]]);
+			}
+
+			for(uint8_t i = first; i < last; ++i){
+				sum += (uint32_t)v[i];
+			}
+
+			*sample = (uint16_t)(sum / (uint32_t)(last - first));
+		}
+	}
+}
+#endif
+
+#if ADC_USE_OVERSAMPLING
+/**
+  * @brief Oversampling configuration | restarts decimation period
+  * @param  os      - pointer to oversampling state of rank
+  * @param  shift   - n of 4^n oversampling, 0 disables stage
+  */
+void ADC_Oversampling_Config(ADC_OversamplingTypeDef* os, uint8_t shift){
+
+	os->shift   = 0; // stage disabled while its state is rewritten
+	os->acc     = 0;
+	os->count   = (uint16_t)(1UL << (2U * shift));
+	os->output  = 0;
+	os->outputs = 0;
+	os->shift   = shift;
+}
+
+/**
+  * @brief Oversampling of block | sums 4^n samples of every enabled rank, then stores sum >> n
+  * 	   Raw samples are not stored, decimated rate is independent of DMA half size
+  * @param  os      - array of oversampling states, indexed by rank
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  * @param  active  - bitmask of ranks processed in this block
+  */
+void ADC_Oversampling_ProcessBlock(ADC_OversamplingTypeDef* os, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active){
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++os){
+
+		if((active & (1UL << rank)) == 0){ // rank is not scheduled in this block
+			continue;
+		}
+
+		if(os->shift == 0){ // stage disabled for rank
+			continue;
+		}
+
+		const uint16_t* sample = &block[rank];
+		uint32_t        acc    = os->acc;
+		uint16_t        count  = os->count;
+		uint32_t        scan   = 0;
+
+		while(scan < scans){
+			uint32_t run = (count < scans - scan) ? count : scans - scan; // samples missing in decimation period
+
+			acc    += ADC_Kernel_Sum(sample, ranks, run);
+			count  -= (uint16_t)run;
+			sample += run * ranks;
+			scan   += run;
+
+			if(count == 0){ // decimation period completed
+				os->output = acc >> os->shift;
+				os->outputs++;
+
+				acc   = 0;
+				count = (uint16_t)(1UL << (2U * os->shift));
+			}
+		}
+
+		os->acc   = acc;
+		os->count = count;
+	}
+}
+#endif
+
+#if ADC_USE_EMA
+/**
+  * @brief Exponential moving average configuration | accumulator is seeded by next sample
+  * @param  ema     - pointer to EMA state of rank
+  * @param  shift   - k, time constant of 2^k samples, 0 disables stage
+  */
+void ADC_Ema_Config(ADC_EmaTypeDef* ema, uint8_t shift){
+
+	ema->shift = 0; // stage disabled while its state is rewritten
+	ema->acc   = 0;
+	ema->shift = shift;
+}
+
+/**
+  * @brief Exponential moving average of block | one shift, one subtraction and one addition per sample
+  * @param  ema     - array of EMA states, indexed by rank
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  * @param  active  - bitmask of ranks processed in this block
+  */
+void ADC_Ema_ProcessBlock(ADC_EmaTypeDef* ema, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active){
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++ema){
+
+		if((active & (1UL << rank)) == 0){ // rank is not scheduled in this block
+			continue;
+		}
+
+		if(ema->shift == 0){ // stage disabled for rank
+			continue;
+		}
+
+		const uint16_t* sample = &block[rank];
+		uint8_t         shift  = ema->shift;
+		uint32_t        acc    = ema->acc;
+
+		if(acc == 0){ // seeding by first sample, filter does not ramp up from zero
+			acc = (uint32_t)*sample << shift;
+		}
+
+		for(uint32_t scan = 0; scan < scans; ++scan, sample += ranks){
+			acc = acc - (acc >> shift) + *sample;
+		}
+
+		ema->acc = acc;
+	}
+}
+#endif
+
+#if ADC_USE_STATS
+/**
+  * @brief Statistics configuration | starts new window, no window is completed until length samples are collected
+  * @param  stats   - pointer to statistics state of rank
+  * @param  length  - window length in samples, 1 - ADC_STATS_MAX_WINDOW, 0 disables stage
+  */
+void ADC_Stats_Config(ADC_StatsTypeDef* stats, uint32_t length){
+
+	stats->length     = 0; // stage disabled while its state is rewritten
+	stats->sum        = 0;
+	stats->count      = 0;
+	stats->min        = 0xFFFF;
+	stats->max        = 0;
+	stats->resultMin  = 0;
+	stats->resultMax  = 0;
+	stats->resultMean = 0;
+	stats->windows    = 0;
+	stats->length     = length;
+}
+
+/**
+  * @brief Statistics of block | single pass by kernels over runs of samples within window, completed window is published and next window starts
+  * @param  stats   - array of statistics states, indexed by rank
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  * @param  active  - bitmask of ranks processed in this block
+  */
+void ADC_Stats_ProcessBlock(ADC_StatsTypeDef* stats, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active){
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++stats){
+
+		if((active & (1UL << rank)) == 0){ // rank is not scheduled in this block
+			continue;
+		}
+
+		if(stats->length == 0){ // stage disabled for rank
+			continue;
+		}
+
+		const uint16_t* sample = &block[rank];
+		uint32_t        scan   = 0;
+
+		while(scan < scans){
+			uint32_t run = stats->length - stats->count; // samples missing in window
+
+			if(run > scans - scan){
+				run = scans - scan;
+			}
+
+			stats->sum   += ADC_Kernel_SumMinMax(sample, ranks, run, &stats->min, &stats->max);
+			stats->count += run;
+			sample       += run * ranks;
+			scan         += run;
+
+			if(stats->count == stats->length){ // window completed
+				stats->resultMin  = stats->min;
+				stats->resultMax  = stats->max;
+				stats->resultMean = (uint16_t)(stats->sum / stats->length);
+				stats->windows++;
+
+				stats->sum   = 0;
+				stats->count = 0;
+				stats->min   = 0xFFFF;
+				stats->max   = 0;
+			}
+		}
+	}
+}
+
+/**
+  * @brief Statistics of last completed window | consistency of fields is ensured by caller
+  * @param  stats    - pointer to statistics state of rank
+  * @param  snapshot - pointer to returned statistics
+  */
+void ADC_Stats_Read(const ADC_StatsTypeDef* stats, ADC_StatsSnapshotTypeDef* snapshot){
+
+	snapshot->min        = stats->resultMin;
+	snapshot->max        = stats->resultMax;
+	snapshot->mean       = stats->resultMean;
+	snapshot->peakToPeak = stats->resultMax - stats->resultMin;
+	snapshot->windows    = stats->windows;
+}
+#endif
+
+#if ADC_USE_POWER
+/**
+  * @brief Integer square root | bitwise, fixed number of iterations
+  * @param  value   - radicand
+  * @retval root    - floor of square root
+  */
+static uint16_t ADC_Sqrt(uint32_t value){
+	uint32_t root = 0;
+
+	for(uint32_t bit = 1UL << 30; bit != 0; bit >>= 2){
+
+		if(value >= root + bit){
+			value -= root + bit;
+			root   = (root >> 1) + bit;
+		}else{
+			root >>= 1;
+		}
+	}
+
+	return (uint16_t)root;
+}
+
+/**
+  * @brief Power configuration of channel pair | starts new window
+  * @param  power         - pointer to power state of pair
+  * @param  rankVoltage   - rank of voltage channel
+  * @param  rankCurrent   - rank of current channel
+  * @param  currentSlave  - 1 - current channel is converted by slave ADC, rankCurrent is rank of slave
+  * @param  offsetVoltage - zero of voltage channel in LSB
+  * @param  offsetCurrent - zero of current channel in LSB
+  * @param  length        - window length in samples, 0 disables pair
+  */
+void ADC_Power_Config(ADC_PowerTypeDef* power, uint8_t rankVoltage, uint8_t rankCurrent, uint8_t currentSlave,
+					  uint16_t offsetVoltage, uint16_t offsetCurrent, uint32_t length){
+
+	power->length        = 0; // pair disabled while its state is rewritten
+	power->sumVV         = 0;
+	power->sumII         = 0;
+	power->sumVI         = 0;
+	power->count         = 0;
+	power->rankVoltage   = rankVoltage;
+	power->rankCurrent   = rankCurrent;
+	power->currentSlave  = currentSlave;
+	power->offsetVoltage = offsetVoltage;
+	power->offsetCurrent = offsetCurrent;
+	power->rmsVoltage    = 0;
+	power->rmsCurrent    = 0;
+	power->power         = 0;
+	power->updates       = 0;
+	power->length        = length;
+}
+
+/**
+  * @brief Sum of products of two strided channels, both taken relative to their offsets
+  * 	   On cores with DSP extension two scans are accumulated by one dual 16-bit multiply-accumulate
+  * @param  voltage       - first voltage sample
+  * @param  voltageStride - distance of consecutive voltage samples
+  * @param  current       - first current sample
+  * @param  currentStride - distance of consecutive current samples
+  * @param  count         - number of scans
+  * @param  offsetVoltage - zero of voltage channel | |sample - offset| < 32768
+  * @param  offsetCurrent - zero of current channel | |sample - offset| < 32768
+  * @retval sum           - sum of (voltage - offsetVoltage) * (current - offsetCurrent)
+  */
+static int64_t ADC_Power_SumProducts(const uint16_t* voltage, uint32_t voltageStride, const uint16_t* current, uint32_t currentStride,
+									 uint32_t count, uint16_t offsetVoltage, uint16_t offsetCurrent){
+	int64_t sum = 0;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	for(; count >= 2U; count -= 2U, voltage += 2U * voltageStride, current += 2U * currentStride){ // deviations packed in halfwords
+		uint32_t v = __PKHBT((uint32_t)((int32_t)voltage[0] - offsetVoltage), (uint32_t)((int32_t)voltage[voltageStride] - offsetVoltage), 16);
+		uint32_t i = __PKHBT((uint32_t)((int32_t)current[0] - offsetCurrent), (uint32_t)((int32_t)current[currentStride] - offsetCurrent), 16);
+
+		sum = (int64_t)__SMLALD(v, i, (uint64_t)sum);
+	}
+#endif
+
+	for(; count > 0; --count, voltage += voltageStride, current += currentStride){
+		sum += (int64_t)((int32_t)*voltage - offsetVoltage) * ((int32_t)*current - offsetCurrent);
+	}
+
+	return sum;
+}
+
+/**
+  * @brief Power of block | sums of squares and cross products of channel pair, completed window is published
+  * 	   Block is split at window end into runs, sums of squares of every run are taken by ADC_Kernel_SumSquares
+  * 	   Channels can be in blocks of different ADCs converting simultaneously, with the same number of scans
+  * @param  power        - pointer to power state of pair
+  * @param  voltageBlock - scans interleaved by ranks, holding voltage channel
+  * @param  voltageRanks - number of ranks in scan of voltageBlock
+  * @param  currentBlock - scans interleaved by ranks, holding current channel, can be voltageBlock
+  * @param  currentRanks - number of ranks in scan of currentBlock
+  * @param  scans        - number of scans in block
+  */
+void ADC_Power_ProcessBlock(ADC_PowerTypeDef* power, const uint16_t* voltageBlock, uint8_t voltageRanks,
+							const uint16_t* currentBlock, uint8_t currentRanks, uint32_t scans){
+	uint32_t length = power->length;
+
+	if(length == 0 || power->rankVoltage >= voltageRanks || power->rankCurrent >= currentRanks){ // pair disabled
+		return;
+	}
+
+	const uint16_t* voltage = &voltageBlock[power->rankVoltage];
+	const uint16_t* current = &currentBlock[power->rankCurrent];
+	uint32_t scan           = 0;
+
+	while(scan < scans){
+		uint32_t run = scans - scan;
+
+		if(run > length - power->count){ // run ends with window
+			run = length - power->count;
+		}
+
+		power->sumVV += (int64_t)ADC_Kernel_SumSquares(voltage, voltageRanks, run, power->offsetVoltage);
+		power->sumII += (int64_t)ADC_Kernel_SumSquares(current, currentRanks, run, power->offsetCurrent);
+		power->sumVI += ADC_Power_SumProducts(voltage, voltageRanks, current, currentRanks, run, power->offsetVoltage, power->offsetCurrent);
+
+		voltage      += run * voltageRanks;
+		current      += run * currentRanks;
+		scan         += run;
+		power->count += run;
+
+		if(power->count == length){ // window completed
+			power->rmsVoltage = ADC_Sqrt((uint32_t)(power->sumVV / length));
+			power->rmsCurrent = ADC_Sqrt((uint32_t)(power->sumII / length));
+			power->power      = (int32_t)(power->sumVI / (int64_t)length);
+			power->updates++;
+
+			power->sumVV = 0;
+			power->sumII = 0;
+			power->sumVI = 0;
+			power->count = 0;
+		}
+	}
+}
+
+/**
+  * @brief Power of last completed window | consistency of fields is ensured by caller
+  * @param  power    - pointer to power state of pair
+  * @param  snapshot - pointer to returned values
+  */
+void ADC_Power_Read(const ADC_PowerTypeDef* power, ADC_PowerSnapshotTypeDef* snapshot){
+
+	snapshot->rmsVoltage = power->rmsVoltage;
+	snapshot->rmsCurrent = power->rmsCurrent;
+	snapshot->power      = power->power;
+	snapshot->updates    = power->updates;
+}
+#endif
+
+#if ADC_USE_GOERTZEL
+/**
+  * @brief Goertzel bin configuration | bin k of length-point DFT, integer k keeps DC out of bin
+  * @param  bin     - pointer to Goertzel bin
+  * @param  rank    - rank of analysed channel
+  * @param  k       - index of bin, 1 - length / 2 - 1
+  * @param  length  - block length in samples, 0 disables bin
+  */
+void ADC_Goertzel_Config(ADC_GoertzelTypeDef* bin, uint8_t rank, uint32_t k, uint32_t length){
+
+	bin->length  = 0; // bin disabled while its state is rewritten
+	bin->rank    = rank;
+	bin->coeff   = (length != 0) ? (int32_t)(2.0f * cosf(2.0f * 3.14159265f * (float)k / (float)length) * (float)(1UL << ADC_GOERTZEL_COEFF_Q)) : 0;
+	bin->s1      = 0;
+	bin->s2      = 0;
+	bin->count   = 0;
+	bin->power   = 0;
+	bin->updates = 0;
+	bin->length  = length;
+}
+
+/**
+  * @brief Goertzel of block | one multiply-accumulate per sample, |X(k)|^2 is published after every length samples
+  * @param  bin     - pointer to Goertzel bin
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  */
+void ADC_Goertzel_ProcessBlock(ADC_GoertzelTypeDef* bin, const uint16_t* block, uint8_t ranks, uint32_t scans){
+
+	if(bin->length == 0 || bin->rank >= ranks){ // bin disabled
+		return;
+	}
+
+	const uint16_t* sample = &block[bin->rank];
+	int32_t coeff          = bin->coeff;
+	int32_t s1             = bin->s1;
+	int32_t s2             = bin->s2;
+
+	for(uint32_t scan = 0; scan < scans; ++scan, sample += ranks){
+		int32_t s0 = (int32_t)*sample + (int32_t)(((int64_t)coeff * s1) >> ADC_GOERTZEL_COEFF_Q) - s2;
+
+		s2 = s1;
+		s1 = s0;
+
+		if(++bin->count == bin->length){ // block completed | |X|^2 = s1^2 + s2^2 - coeff s1 s2
+			int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2 - (((int64_t)coeff * s1) >> ADC_GOERTZEL_COEFF_Q) * s2;
+
+			bin->power = (power > 0) ? (uint64_t)power : 0;
+			bin->updates++;
+
+			s1         = 0;
+			s2         = 0;
+			bin->count = 0;
+		}
+	}
+
+	bin->s1 = s1;
+	bin->s2 = s2;
+}
+#endif
+
+#if ADC_USE_WATCHDOG
+/**
+  * @brief Watchdog configuration of rank | state returns to normal
+  * @param  watchdog   - pointer to watchdog state of rank
+  * @param  low        - low threshold
+  * @param  high       - high threshold
+  * @param  hysteresis - hysteresis of both thresholds
+  * @param  debounce   - consecutive samples needed to change state, 0 disables watchdog
+  */
+void ADC_Watchdog_Config(ADC_WatchdogTypeDef* watchdog, uint16_t low, uint16_t high, uint16_t hysteresis, uint16_t debounce){
+
+	watchdog->debounce   = 0; // watchdog disabled while its state is rewritten
+	watchdog->low        = low;
+	watchdog->high       = high;
+	watchdog->hysteresis = hysteresis;
+	watchdog->count      = 0;
+	watchdog->pending    = ADC_WATCHDOG_NORMAL;
+	watchdog->state      = ADC_WATCHDOG_NORMAL;
+	watchdog->debounce   = debounce;
+}
+
+/**
+  * @brief Watchdog of block | every sample votes for state, handler is called at once when state changes
+  * 	   Only consecutive votes for the same new state are counted, e.g. HIGH to LOW needs debounce samples below low
+  * @param  filters - pointer to processing stages of ADC, holding watchdogs and handler
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  */
+void ADC_Watchdog_ProcessBlock(ADC_FiltersTypeDef* filters, const uint16_t* block, uint8_t ranks, uint32_t scans){
+	ADC_WatchdogTypeDef* watchdog = filters->watchdog;
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++watchdog){
+
+		if(watchdog->debounce == 0){ // watchdog disabled for rank
+			continue;
+		}
+
+		const uint16_t* sample = &block[rank];
+		uint8_t state          = watchdog->state;
+		int32_t high           = watchdog->high;
+		int32_t low            = watchdog->low;
+
+		// thresholds of leaving current state are moved by hysteresis
+		if(state == ADC_WATCHDOG_HIGH){
+			high -= watchdog->hysteresis;
+		}else if(state == ADC_WATCHDOG_LOW){
+			low  += watchdog->hysteresis;
+		}
+
+		for(uint32_t scan = 0; scan < scans; ++scan, sample += ranks){
+			int32_t value = *sample;
+			uint8_t vote  = (value > high) ? ADC_WATCHDOG_HIGH : (value < low) ? ADC_WATCHDOG_LOW : ADC_WATCHDOG_NORMAL;
+
+			if(vote == state){
+				watchdog->count = 0;
+				continue;
+			}
+
+			if(vote != watchdog->pending){ // other direction of change, debounce starts again
+				watchdog->pending = vote;
+				watchdog->count   = 0;
+			}
+
+			if(++watchdog->count < watchdog->debounce){
+				continue;
+			}
+
+			state           = vote;
+			watchdog->state = vote;
+			watchdog->count = 0;
+			high            = watchdog->high;
+			low             = watchdog->low;
+
+			if(state == ADC_WATCHDOG_HIGH){
+				high -= watchdog->hysteresis;
+			}else if(state == ADC_WATCHDOG_LOW){
+				low  += watchdog->hysteresis;
+			}
+
+#if ADC_USE_CAPTURE
+			if(filters->capture.freezeOnFault != 0 && state != ADC_WATCHDOG_NORMAL){ // fault freezes capture after post-trigger entries
+				ADC_Capture_Trigger(&filters->capture);
+			}
+#endif
+
+			if(filters->watchdogHandler != NULL){
+				filters->watchdogHandler(filters->watchdogOwner, rank, (ADC_WatchdogStateTypeDef)state, (uint16_t)value);
+			}
+		}
+	}
+}
+#endif
+
+#if ADC_USE_CAPTURE
+/**
+  * @brief Reversal of entries in range [first, last)
+  * @param  entry   - array of entries
+  * @param  first   - first reversed entry
+  * @param  last    - entry after last reversed one
+  */
+static void ADC_Capture_Reverse(ADC_CaptureEntryTypeDef* entry, uint16_t first, uint16_t last){
+
+	while(first + 1 < last){
+		ADC_CaptureEntryTypeDef swap = entry[first];
+		entry[first]                 = entry[--last];
+		entry[last]                  = swap;
+		first++;
+	}
+}
+
+/**
+  * @brief Capture arming | ring is emptied and recording restarts, configuration is kept
+  * @param  capture - pointer to capture ring
+  */
+void ADC_Capture_Arm(ADC_CaptureTypeDef* capture){
+
+	capture->state     = ADC_CAPTURE_IDLE; // recording stopped while ring is rewritten
+	capture->phase     = 0;
+	capture->head      = 0;
+	capture->count     = 0;
+	capture->remaining = 0;
+
+	if(capture->channels != 0){
+		capture->state = ADC_CAPTURE_ARMED;
+	}
+}
+
+/**
+  * @brief Capture trigger | ring freezes after post-trigger entries, later triggers are ignored
+  * @param  capture - pointer to capture ring
+  */
+void ADC_Capture_Trigger(ADC_CaptureTypeDef* capture){
+
+	if(capture->state != ADC_CAPTURE_ARMED){
+		return;
+	}
+
+	capture->remaining = capture->postTrigger;
+	capture->state     = (capture->postTrigger == 0) ? ADC_CAPTURE_FROZEN : ADC_CAPTURE_TRIGGERED;
+}
+
+/**
+  * @brief Capture of block | every decimation-th scan of recorded channels is written with its own timestamp,
+  * 	   timestamp of block is taken at end of DMA half, so it belongs to last scan and earlier scans are scanPeriod apart
+  * @param  capture - pointer to capture ring
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  */
+void ADC_Capture_ProcessBlock(ADC_CaptureTypeDef* capture, const uint16_t* block, uint8_t ranks, uint32_t scans){
+
+	if(capture->state != ADC_CAPTURE_ARMED && capture->state != ADC_CAPTURE_TRIGGERED){
+		return;
+	}
+
+	// time of first scan in Q ADC_CAPTURE_PERIOD_Q, modulo 2^32 ticks like timestamp itself
+	uint64_t time = ((uint64_t)ADC_CAPTURE_TIMESTAMP() << ADC_CAPTURE_PERIOD_Q) - (uint64_t)(scans - 1U) * capture->scanPeriod;
+
+	for(uint32_t scan = 0; scan < scans; ++scan, block += ranks, time += capture->scanPeriod){
+
+		if(capture->phase != 0){ // decimated scan
+			capture->phase--;
+			continue;
+		}
+
+		capture->phase = capture->decimation - 1;
+
+		ADC_CaptureEntryTypeDef* entry = &capture->entry[capture->head];
+
+		entry->timestamp = (uint32_t)(time >> ADC_CAPTURE_PERIOD_Q);
+
+		for(uint8_t i = 0; i < capture->channels; ++i){
+			entry->sample[i] = block[capture->rank[i]];
+		}
+
+		capture->head = (capture->head + 1 == ADC_CAPTURE_DEPTH) ? 0 : capture->head + 1;
+
+		if(capture->count < ADC_CAPTURE_DEPTH){
+			capture->count++;
+		}
+
+		if(capture->state == ADC_CAPTURE_TRIGGERED && --capture->remaining == 0){ // post-trigger entries recorded
+			capture->state = ADC_CAPTURE_FROZEN;
+			return;
+		}
+	}
+}
+
+/**
+  * @brief Capture export | frozen ring is rotated in place, so entries are contiguous from oldest to newest
+  * 	   Exported are up to preTrigger entries before trigger and all post-trigger entries
+  * @param  capture - pointer to capture ring, must be frozen
+  * @param  entries - pointer to returned address of first entry
+  * @retval count   - number of exported entries
+  */
+uint16_t ADC_Capture_Export(ADC_CaptureTypeDef* capture, const ADC_CaptureEntryTypeDef** entries){
+	uint16_t count = capture->preTrigger + capture->postTrigger;
+	uint16_t start = capture->head; // oldest entry of full ring
+
+	if(count > capture->count){
+		count = capture->count;
+	}
+
+	if(capture->count < ADC_CAPTURE_DEPTH){ // ring not wrapped, oldest entry is first
+		start = 0;
+	}
+
+	if(start != 0){ // rotating by three reversals, oldest entry is moved to index 0 without extra buffer
+		ADC_Capture_Reverse(capture->entry, 0, start);
+		ADC_Capture_Reverse(capture->entry, start, ADC_CAPTURE_DEPTH);
+		ADC_Capture_Reverse(capture->entry, 0, ADC_CAPTURE_DEPTH);
+
+		capture->head = 0; // ring is linear now, newest entry is last
+	}
+
+	*entries = &capture->entry[capture->count - count];
+
+	return count;
+}
+#endif
+
+#if ADC_USE_NOTCH
+/**
+  * @brief Notch design | one section per harmonic of frequency below Nyquist frequency, coefficients are converted to fixed-point once
+  * 	   Float math is used only here, never in DMA callbacks
+  * @param  bank       - pointer to notch coefficients
+  * @param  sampleRate - sample rate of every channel in Hz
+  * @param  frequency  - ripple frequency in Hz
+  * @param  harmonics  - number of notched harmonics, 1 - ADC_NOTCH_MAX_HARMONICS
+  * @retval sections   - number of designed sections, 0 if no harmonic is below Nyquist frequency
+  */
+uint8_t ADC_Notch_Design(ADC_NotchBankTypeDef* bank, float sampleRate, float frequency, uint8_t harmonics){
+	const float one = (float)(1UL << ADC_NOTCH_COEFF_Q);
+	const float pi  = 3.14159265f;
+	float r         = 1.0f - pi * ADC_NOTCH_BANDWIDTH / sampleRate; // pole radius from notch width
+	uint8_t count   = 0;
+
+	bank->sections = 0; // notch disabled while coefficients are rewritten
+
+	for(uint8_t k = 1; k <= harmonics && k <= ADC_NOTCH_MAX_HARMONICS; ++k){
+
+		if(2.0f * k * frequency >= sampleRate){ // harmonic above Nyquist frequency
+			break;
+		}
+
+		float c  = cosf(2.0f * pi * k * frequency / sampleRate);
+		float a1 = -2.0f * r * c;
+		float a2 = r * r;
+		float g  = (1.0f + a1 + a2) / (2.0f - 2.0f * c); // unity gain at DC
+
+		bank->section[count].b0 = (int32_t)(g * one);
+		bank->section[count].b1 = (int32_t)(-2.0f * c * g * one);
+		bank->section[count].a1 = (int32_t)(a1 * one);
+		bank->section[count].a2 = (int32_t)(a2 * one);
+		count++;
+	}
+
+	bank->sections = count;
+
+	return count;
+}
+
+/**
+  * @brief Notch configuration of rank | histories are seeded by next sample
+  * @param  notch   - pointer to notch state of rank
+  * @param  enabled - 1 enables stage for rank
+  */
+void ADC_Notch_Config(ADC_NotchTypeDef* notch, uint8_t enabled){
+
+	notch->enabled = 0; // stage disabled while its state is rewritten
+	notch->primed  = 0;
+	notch->output  = 0;
+	notch->enabled = enabled;
+}
+
+/**
+  * @brief Notch of block | cascade of biquad sections, 64-bit accumulation of fixed-point products
+  * @param  bank    - pointer to notch coefficients
+  * @param  notch   - array of notch states, indexed by rank
+  * @param  block   - scans interleaved by ranks
+  * @param  ranks   - number of ranks in scan
+  * @param  scans   - number of scans in block
+  * @param  active  - bitmask of ranks processed in this block
+  */
+void ADC_Notch_ProcessBlock(const ADC_NotchBankTypeDef* bank, ADC_NotchTypeDef* notch, const uint16_t* block, uint8_t ranks, uint32_t scans, uint32_t active){
+	uint8_t sections = bank->sections;
+
+	if(sections == 0){ // notch not designed
+		return;
+	}
+
+	for(uint8_t rank = 0; rank < ranks; ++rank, ++notch){
+
+		if((active & (1UL << rank)) == 0){ // rank is not scheduled in this block
+			continue;
+		}
+
+		if(notch->enabled == 0){ // stage disabled for rank
+			continue;
+		}
+
+		const uint16_t* sample = &block[rank];
+
+		if(notch->primed == 0 && scans != 0){ // seeding histories with DC of first sample, filter starts in steady state
+			int32_t dc = (int32_t)*sample << ADC_NOTCH_STATE_Q;
+
+			for(uint8_t k = 0; k <= sections; ++k){
+				notch->z[k][0] = dc;
+				notch->z[k][1] = dc;
+			}
+
+			notch->primed = 1;
+		}
+
+		for(uint32_t scan = 0; scan < scans; ++scan, sample += ranks){
+			int32_t x = (int32_t)*sample << ADC_NOTCH_STATE_Q;
+
+			for(uint8_t k = 0; k < sections; ++k){
+				const ADC_NotchSectionTypeDef* c = &bank->section[k];
+				int32_t* in  = notch->z[k];
+				int32_t* out = notch->z[k + 1];
+				int64_t  acc;
+
+				acc  = (int64_t)c->b0 * (x + in[1]);
+				acc += (int64_t)c->b1 * in[0];
+				acc -= (int64_t)c->a1 * out[0];
+				acc -= (int64_t)c->a2 * out[1];
+
+				in[1] = in[0];
+				in[0] = x;
+
+				x = (int32_t)(acc >> ADC_NOTCH_COEFF_Q); // output of section is input of next one
+			}
+
+			// output history of last section
+			notch->z[sections][1] = notch->z[sections][0];
+			notch->z[sections][0] = x;
+			notch->output         = x;
+		}
+	}
+}
+
+/**
+  * @brief Notch value of rank | rounded and limited to 16-bit
+  * @param  notch   - pointer to notch state of rank
+  * @retval value   - filtered value
+  */
+uint16_t ADC_Notch_Read(const ADC_NotchTypeDef* notch){
+	int32_t value = (notch->output + (1L << (ADC_NOTCH_STATE_Q - 1))) >> ADC_NOTCH_STATE_Q;
+
+	if(value < 0){
+		return 0;
+	}
+
+	return (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+}
+#endif
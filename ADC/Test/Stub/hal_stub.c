@@ -0,0 +1,53 @@
+/*
+ * hal_stub.c
+ *
+ *  Host stub of STM32 HAL functions used by ADC driver. Starting and stopping always succeeds,
+ *  conversions return values set by test.
+ */
+
+#include "main.h"
+
+ADC_TypeDef stub_adc1, stub_adc2, stub_adc3;
+ADC_Common_TypeDef stub_adc_common;
+
+uint32_t stub_ge;
+uint32_t stub_tick;
+uint32_t stub_adc_value;
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* buffer, uint32_t length){ UNUSED(hadc); UNUSED(buffer); UNUSED(length); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef* hadc, uint32_t timeout){ UNUSED(hadc); UNUSED(timeout); return HAL_OK; }
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return stub_adc_value; }
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* buffer, uint32_t length){ UNUSED(hadc); UNUSED(buffer); UNUSED(length); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+uint32_t HAL_ADCEx_MultiModeGetValue(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return stub_adc_value; }
+#if defined(STM32H743xx)
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t mode, uint32_t input){ UNUSED(hadc); UNUSED(mode); UNUSED(input); return HAL_OK; }
+#elif defined(STM32F303xC) || defined(STM32G474xx) || defined(STM32L476xx)
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t input){ UNUSED(hadc); UNUSED(input); return HAL_OK; }
+#else
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+#endif
+
+HAL_StatusTypeDef HAL_ADCEx_InjectedConfigChannel(ADC_HandleTypeDef* hadc, ADC_InjectionConfTypeDef* config){ UNUSED(hadc); UNUSED(config); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADCEx_InjectedStart_IT(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+HAL_StatusTypeDef HAL_ADCEx_InjectedStop_IT(ADC_HandleTypeDef* hadc){ UNUSED(hadc); return HAL_OK; }
+uint32_t HAL_ADCEx_InjectedGetValue(ADC_HandleTypeDef* hadc, uint32_t rank){ UNUSED(hadc); UNUSED(rank); return stub_adc_value; }
+
+uint32_t HAL_GetTick(void){ return stub_tick; }
+uint32_t HAL_RCC_GetHCLKFreq(void){ return 72000000U; }
+uint32_t HAL_RCC_GetPCLK1Freq(void){ return 36000000U; }
+uint32_t HAL_RCC_GetPCLK2Freq(void){ return 72000000U; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim){
+	htim->Instance->PSC = htim->Init.Prescaler;
+	htim->Instance->ARR = htim->Init.Period;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim){ UNUSED(htim); return HAL_OK; }
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim){ UNUSED(htim); return HAL_OK; }
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* config){ UNUSED(htim); UNUSED(config); return HAL_OK; }
@@ -0,0 +1,221 @@
+/*
+ * main.h
+ *
+ *  Host stub of STM32 HAL, only what ADC driver needs to build and run tests on PC.
+ *  Registers are plain variables, HAL functions are defined in hal_stub.c.
+ */
+
+#ifndef STUB_MAIN_H
+#define STUB_MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Core ------------------------------------------------------------------------------- */
+#define __IO				volatile
+#define __weak				__attribute__((weak))
+#define UNUSED(x)			((void)(x))
+#define READ_REG(r)			(r)
+#define WRITE_REG(r, v)		((r) = (v))
+#define READ_BIT(r, b)		((r) & (b))
+#define SET_BIT(r, b)		((r) |= (b))
+#define CLEAR_BIT(r, b)		((r) &= ~(b))
+#define MODIFY_REG(r, c, s)	((r) = (((r) & ~(c)) | (s)))
+#define ENABLE				1U
+#define DISABLE				0U
+
+#define __disable_irq()		do{}while(0)
+#define __enable_irq()		do{}while(0)
+static inline uint32_t __get_PRIMASK(void){ return 0; }
+static inline void __set_PRIMASK(uint32_t x){ (void)x; }
+static inline void __DMB(void){}
+
+/*  C models of DSP extension instructions, used when test builds kernels with -D__ARM_FEATURE_DSP=1.
+ *  GE flags are kept in a variable, as __USUB16 sets them for the next __SEL */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+extern uint32_t stub_ge;
+
+static inline uint32_t __PKHBT(uint32_t a, uint32_t b, int shift){
+	return (a & 0xFFFFU) | ((b << shift) & 0xFFFF0000U);
+}
+
+static inline uint64_t __SMLALD(uint32_t a, uint32_t b, uint64_t acc){
+	return acc + (uint64_t)((int64_t)(int16_t)a * (int16_t)b + (int64_t)(int16_t)(a >> 16) * (int16_t)(b >> 16));
+}
+
+static inline uint32_t __USUB16(uint32_t a, uint32_t b){
+	stub_ge = (((a & 0xFFFFU) >= (b & 0xFFFFU)) ? 1U : 0U) | (((a >> 16) >= (b >> 16)) ? 2U : 0U);
+	return ((a - b) & 0xFFFFU) | (((a >> 16) - (b >> 16)) << 16);
+}
+
+static inline uint32_t __SEL(uint32_t a, uint32_t b){
+	return (((stub_ge & 1U) ? a : b) & 0xFFFFU) | (((stub_ge & 2U) ? a : b) & 0xFFFF0000U);
+}
+#endif
+
+/* Peripherals ------------------------------------------------------------------------ */
+typedef enum {HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT} HAL_StatusTypeDef;
+
+typedef struct {
+	__IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR1, JOFR2, JOFR3, JOFR4, HTR, LTR, SQR1, SQR2, SQR3, SQR4, JSQR, JDR1, JDR2, JDR3, JDR4, DR;
+	__IO uint32_t ISR, IER, CR, CFGR, CFGR2, SMPR3, PCSEL;
+} ADC_TypeDef;
+
+typedef struct {
+	__IO uint32_t CSR, CCR, CDR;
+} ADC_Common_TypeDef;
+
+typedef struct {
+	__IO uint32_t CCR, CNDTR, CPAR, CMAR, CR, NDTR, PAR, M0AR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+	DMA_Channel_TypeDef* Instance;
+} DMA_HandleTypeDef;
+
+typedef struct {
+	uint32_t NbrOfConversion, ContinuousConvMode, ExternalTrigConv, Resolution, ScanConvMode, DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct {
+	ADC_TypeDef* Instance;
+	ADC_InitTypeDef Init;
+	DMA_HandleTypeDef* DMA_Handle;
+} ADC_HandleTypeDef;
+
+typedef struct {
+	uint32_t InjectedChannel, InjectedRank, InjectedSamplingTime, InjectedOffset, InjectedNbrOfConversion, InjectedDiscontinuousConvMode;
+	uint32_t AutoInjectedConv, ExternalTrigInjecConv, ExternalTrigInjecConvEdge, InjectedSingleDiff, InjectedOffsetNumber, QueueInjectedContext;
+} ADC_InjectionConfTypeDef;
+
+typedef struct {
+	__IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR, CCR1, CCR2, CCR3, CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+	uint32_t Prescaler, CounterMode, Period, ClockDivision, RepetitionCounter, AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+	TIM_TypeDef* Instance;
+	TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+	uint32_t MasterOutputTrigger, MasterOutputTrigger2, MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+extern ADC_TypeDef stub_adc1, stub_adc2, stub_adc3;
+extern ADC_Common_TypeDef stub_adc_common;
+
+#define ADC1						(&stub_adc1)
+#define ADC2						(&stub_adc2)
+#define ADC3						(&stub_adc3)
+#define ADC_COMMON					(&stub_adc_common)
+#define ADC123_COMMON				(&stub_adc_common)
+#define ADC12_COMMON				(&stub_adc_common)
+#define __LL_ADC_COMMON_INSTANCE(x)	(&stub_adc_common)
+#define APB2PERIPH_BASE				0x40010000UL
+
+/* Register bits ---------------------------------------------------------------------- */
+#define ADC_CR1_DUALMOD_Pos			16
+#define ADC_CR1_RES_Pos				24
+#define ADC_SR_STRT_Pos				4
+#define ADC_SR_EOC_Pos				1
+#define ADC_CR2_DMA_Pos				8
+#define ADC_CR2_CONT_Pos			1
+#define ADC_CR2_CONT				(1U << 1)
+#define ADC_CR2_EXTSEL				(7U << 17)
+#define ADC_CR2_EXTTRIG				(1U << 20)
+#define ADC_CR2_EXTEN				(3U << 28)
+#define ADC_CR2_EXTEN_0				(1U << 28)
+#define ADC_SQR1_L_Pos				20
+#define ADC_CCR_MULTI_Msk			0x1FU
+#define ADC_CCR_MULTI_0				0x1U
+#define ADC12_CCR_MULTI_Msk			0x1FU
+#define ADC_CCR_DUAL				0x1FU
+#define ADC_CCR_DMA					(3U << 14)
+#define ADC_CCR_DMA_1				(2U << 14)
+#define ADC_CCR_MDMA				(3U << 14)
+#define ADC_CCR_MDMA_1				(2U << 14)
+#define ADC12_CCR_MDMA				(3U << 14)
+#define ADC12_CCR_MDMA_1			(2U << 14)
+#define ADC_CCR_DAMDF				(3U << 14)
+#define ADC_CCR_DAMDF_1				(2U << 14)
+#define ADC_CR_ADSTART_Pos			2
+#define ADC_ISR_EOC_Pos				2
+#define ADC_CFGR_DMAEN				0x1U
+#define ADC_CFGR_DMACFG_Pos			1
+#define ADC_CFGR_DMNGT_0			0x1U
+#define ADC_CFGR_DMNGT_Pos			0
+#define ADC_CFGR_RES_Pos			3
+#define ADC_CFGR_CONT_Pos			13
+#define ADC_CFGR_CONT				(1U << 13)
+#define ADC_CFGR_EXTSEL				(15U << 6)
+#define ADC_CFGR_EXTEN				(3U << 10)
+#define ADC_CFGR_EXTEN_0			(1U << 10)
+#define ADC_CFGR2_ROVSE				0x1U
+#define ADC_CFGR2_OVSR_Pos			2
+#define ADC_CFGR2_OVSR				(7U << 2)
+#define ADC_CFGR2_OVSS_Pos			5
+#define ADC_CFGR2_OVSS				(15U << 5)
+#define ADC_CFGR2_TROVS				(1U << 9)
+#define ADC_CFGR2_ROVSM				(1U << 10)
+#define DMA_CCR_CIRC_Pos			5
+#define DMA_SxCR_CIRC_Pos			8
+
+/* HAL constants ---------------------------------------------------------------------- */
+#define ADC_SOFTWARE_START			0xE0000U
+#define ADC_INJECTED_RANK_1			1U
+#define ADC_INJECTED_RANK_2			2U
+#define ADC_INJECTED_RANK_3			3U
+#define ADC_INJECTED_RANK_4			4U
+#define __LL_ADC_DECIMAL_NB_TO_CHANNEL(nb)	((uint32_t)(nb) << 26)
+#define ADC_EXTERNALTRIGINJECCONVEDGE_RISING	0x100000U
+#define ADC_OFFSET_NONE				0U
+#define ADC_SINGLE_ENDED			0x7FU
+#define ADC_CALIB_OFFSET			0U
+#define ADC_RESOLUTION_16B			0U
+#define ADC_RESOLUTION_14B			4U
+#define ADC_RESOLUTION_12B			8U
+#define ADC_RESOLUTION_10B			12U
+#define TIM_TRGO_UPDATE				0x20U
+#define TIM_MASTERSLAVEMODE_DISABLE	0U
+#define TIM_COUNTERMODE_UP			0U
+#define TIM_CLOCKDIVISION_DIV1		0U
+
+/* HAL functions ---------------------------------------------------------------------- */
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* buffer, uint32_t length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef* hadc, uint32_t timeout);
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* buffer, uint32_t length);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc);
+uint32_t HAL_ADCEx_MultiModeGetValue(ADC_HandleTypeDef* hadc);
+#if defined(STM32H743xx)
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t mode, uint32_t input);
+#elif defined(STM32F303xC) || defined(STM32G474xx) || defined(STM32L476xx)
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t input);
+#else
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc);
+#endif
+HAL_StatusTypeDef HAL_ADCEx_InjectedConfigChannel(ADC_HandleTypeDef* hadc, ADC_InjectionConfTypeDef* config);
+HAL_StatusTypeDef HAL_ADCEx_InjectedStart_IT(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADCEx_InjectedStop_IT(ADC_HandleTypeDef* hadc);
+uint32_t HAL_ADCEx_InjectedGetValue(ADC_HandleTypeDef* hadc, uint32_t rank);
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* config);
+
+/* Test hooks ------------------------------------------------------------------------- */
+extern uint32_t stub_tick;			// returned by HAL_GetTick
+extern uint32_t stub_adc_value;		// returned by HAL_ADC_GetValue
+
+#endif /* STUB_MAIN_H */
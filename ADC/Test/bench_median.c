@@ -0,0 +1,116 @@
+/*
+ * bench_median.c
+ *
+ *  Host benchmark of median prefilter (windows 3, 5, 7, 9, median and trimmed mean) against ADC_Kernel_Sum,
+ *  which is the cost of plain boxcar averaging of the same block. Timings are of host CPU, so only ratios
+ *  between stages are meaningful for target. Run with `make bench`.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "adc_filters.h"
+
+#define BENCH_RANKS		8U
+#define BENCH_SCANS		64U		// one DMA half of 64 scans
+#define BENCH_BLOCKS	20000U
+
+static uint16_t source[BENCH_RANKS * BENCH_SCANS];
+static uint16_t block[BENCH_RANKS * BENCH_SCANS];
+static ADC_MedianTypeDef median[BENCH_RANKS];
+static volatile uint32_t sink;
+
+static double Now(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void Fill(void){
+	uint32_t seed = 1U;
+
+	for(uint32_t i = 0; i < BENCH_RANKS * BENCH_SCANS; ++i){
+		seed      = seed * 1664525U + 1013904223U;
+		source[i] = (uint16_t)(2048U + ((seed >> 16) & 0xFFU)); // noise around mid scale
+	}
+}
+
+/* ns per sample of median of given window and trim, block is restored before every pass as stage works in place */
+static double BenchMedian(uint8_t size, uint8_t trim){
+
+	for(uint8_t rank = 0; rank < BENCH_RANKS; ++rank){
+		ADC_Median_Config(&median[rank], size, trim);
+	}
+
+	double start = Now();
+
+	for(uint32_t i = 0; i < BENCH_BLOCKS; ++i){
+
+		for(uint32_t j = 0; j < BENCH_RANKS * BENCH_SCANS; ++j){
+			block[j] = source[j];
+		}
+
+		for(uint8_t rank = 0; rank < BENCH_RANKS; ++rank){
+			ADC_Median_ProcessBlock(&median[rank], block, BENCH_RANKS, BENCH_SCANS, 1UL << rank);
+		}
+
+		sink += block[0];
+	}
+
+	return (Now() - start) / ((double)BENCH_BLOCKS * BENCH_RANKS * BENCH_SCANS);
+}
+
+/* ns per sample of copy, which is included in median passes */
+static double BenchCopy(void){
+	double start = Now();
+
+	for(uint32_t i = 0; i < BENCH_BLOCKS; ++i){
+
+		for(uint32_t j = 0; j < BENCH_RANKS * BENCH_SCANS; ++j){
+			block[j] = source[j];
+		}
+
+		sink += block[i & 0xFFU];
+	}
+
+	return (Now() - start) / ((double)BENCH_BLOCKS * BENCH_RANKS * BENCH_SCANS);
+}
+
+/* ns per sample of sums of all ranks of block */
+static double BenchSum(void){
+	double start = Now();
+
+	for(uint32_t i = 0; i < BENCH_BLOCKS; ++i){
+
+		for(uint8_t rank = 0; rank < BENCH_RANKS; ++rank){
+			sink += ADC_Kernel_Sum(&source[rank], BENCH_RANKS, BENCH_SCANS);
+		}
+	}
+
+	return (Now() - start) / ((double)BENCH_BLOCKS * BENCH_RANKS * BENCH_SCANS);
+}
+
+int main(void){
+	Fill();
+
+	double copy = BenchCopy();
+	double sum  = BenchSum();
+
+	printf("bench_median: %u ranks x %u scans, %u blocks, ns per sample (copy of block subtracted)\n", BENCH_RANKS, BENCH_SCANS, BENCH_BLOCKS);
+	printf("  ADC_Kernel_Sum         %6.2f\n", sum);
+
+	for(uint8_t size = 3; size <= ADC_MEDIAN_MAX_SIZE; size += 2){
+		double med = BenchMedian(size, (uint8_t)((size - 1U) / 2U)) - copy;
+
+		printf("  median %u               %6.2f  (%5.1fx sum)\n", size, med, med / sum);
+
+		if(size > 3U){ // trim 1 of window 3 is median
+			double trim = BenchMedian(size, 1) - copy;
+
+			printf("  trimmed mean %u, trim 1 %6.2f  (%5.1fx sum)\n", size, trim, trim / sum);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,19 @@
+/*
+ * footprint.c
+ *
+ *  Prints ADC_Footprint of driver. Built by `make footprint` twice, with default ADC_SEQUENCE_LENGTH and with minimal one,
+ *  so RAM saved by sizing from converted ranks is visible. Buffer, block and averaging are exact for target, context is
+ *  larger on host, because pointers take 8 bytes instead of 4.
+ */
+
+#include <stdio.h>
+#include "adc_driver.h"
+
+int main(void){
+
+	printf("ADC_SEQUENCE_LENGTH %2u: buffer %5u (side by side %5u), block %4u, averaging %4u, context %5u bytes\n",
+		   ADC_Footprint.sequenceLength, ADC_Footprint.buffer, ADC_Footprint.separateBuffers, ADC_Footprint.block,
+		   ADC_Footprint.averaging, ADC_Footprint.context);
+
+	return 0;
+}
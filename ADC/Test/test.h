@@ -0,0 +1,27 @@
+/*
+ * test.h
+ *
+ *  Minimal assertions of host tests. Failed check is printed and counted, test returns number of failures.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static unsigned test_failures = 0;
+
+#define TEST_CHECK(__COND__, ...)							\
+		do{													\
+			if(!(__COND__)){								\
+				++test_failures;							\
+				printf("%s:%d: ", __FILE__, __LINE__);		\
+				printf(__VA_ARGS__);						\
+				printf("\n");								\
+			}												\
+		}while(0)
+
+#define TEST_RESULT(__NAME__)								\
+		(printf("%s: %s (%u failures)\n", (__NAME__), test_failures ? "FAILED" : "passed", test_failures), test_failures ? 1 : 0)
+
+#endif /* TEST_H */
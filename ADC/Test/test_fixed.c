@@ -0,0 +1,90 @@
+/*
+ * test_fixed.c
+ *
+ *  Compares fixed-point path (ADC_GetValueFixed) against float model for all 12-bit codes,
+ *  several full scales and calibration offsets and gains. Error must stay within 1 LSB of full scale.
+ *  ADC runs in polling mode, so every code is returned by HAL_ADC_GetValue stub as it is.
+ */
+
+#include <math.h>
+#include "adc_driver.h"
+#include "test.h"
+
+#define TEST_CHANNEL	5U
+
+static ADC_HandleTypeDef hadc;
+static ADC_ContextTypeDef ctx;
+
+static const float scales[]  = {1.0f, 3.3f, 100.0f, 0.5f};
+static const float gains[]   = {1.0f, 0.9f, 1.1f, 0.5f, 1.97f};
+static const int32_t offsets[] = {0, 37, -20, 4000};
+
+static float worst = 0.0f;		// largest error of all cases, in LSB
+
+static void Setup(void){
+	hadc.Instance    = ADC1;
+	ADC1->SQR1       = 0U;								// one rank
+	ADC1->SQR3       = TEST_CHANNEL;
+	ADC1->CR2        = 0U;								// DMA disabled | polling
+	ADC1->SR         = 1U << ADC_SR_STRT_Pos;			// conversion started
+}
+
+/* Float model of calibration and scaling */
+static float Model(uint16_t code, float max, float gain, int32_t offset){
+	float value = ((float)code - (float)offset) * gain;
+	float full  = (float)ctx.config.resolution;
+
+	value = (value < 0.0f) ? 0.0f : (value > full) ? full : value;
+
+	return value / full * max;
+}
+
+static void CheckScale(float max, float gain, int32_t offset){
+	float lsb = max / (float)ctx.config.resolution;
+
+	TEST_CHECK(ADC_SetScaleFixed(&ctx, TEST_CHANNEL, ADC_TO_FIXED(max)) == ADC_OK, "scale %f rejected", max);
+	TEST_CHECK(ADC_SetCalibration(&ctx, TEST_CHANNEL, offset, (int32_t)lroundf(gain * (float)(1UL << ADC_CALIBRATION_GAIN_Q)), NULL) == ADC_OK,
+			   "calibration rejected");
+
+	for(uint32_t code = 0; code <= ctx.config.resolution; ++code){
+		int32_t fixed;
+		float   reference;
+
+		stub_adc_value = code;
+
+		TEST_CHECK(ADC_GetValueFixed(&ctx, TEST_CHANNEL, &fixed) == ADC_OK, "code %u not read", code);
+
+		if(gain == 1.0f && offset == 0){ // without correction driver's own float path is reference
+			TEST_CHECK(ADC_GetValue(&ctx, max, TEST_CHANNEL, &reference) == ADC_OK, "code %u not read", code);
+		}else{
+			reference = Model((uint16_t)code, max, gain, offset);
+		}
+
+		float error = fabsf((float)fixed / (float)(1UL << ADC_FIXED_Q) - reference);
+		worst       = (error / lsb > worst) ? error / lsb : worst;
+
+		TEST_CHECK(error <= lsb, "max %f gain %f offset %d code %u: fixed %f, float %f",
+				   max, gain, offset, code, (float)fixed / (float)(1UL << ADC_FIXED_Q), reference);
+	}
+}
+
+int main(void){
+	Setup();
+
+	TEST_CHECK(ADC_Init(&ctx, &hadc, NULL) == HAL_OK, "init failed");
+	TEST_CHECK(ctx.config.mode == ADC_MODE_POLLING && ctx.config.resolution == 4095U, "unexpected snapshot");
+
+	for(uint32_t s = 0; s < sizeof(scales) / sizeof(scales[0]); ++s){
+
+		for(uint32_t g = 0; g < sizeof(gains) / sizeof(gains[0]); ++g){
+
+			for(uint32_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); ++o){
+				CheckScale(scales[s], gains[g], offsets[o]);
+			}
+		}
+	}
+
+	printf("test_fixed: worst error %.3f LSB\n", worst);
+
+	return TEST_RESULT("test_fixed");
+}
@@ -0,0 +1,137 @@
+/*
+ * test_kernels.c
+ *
+ *  Compares ADC kernels (sum, sum of squares, fused sum with min and max) against naive loops. Built twice by Makefile: with plain C path and with DSP path
+ *  (-D__ARM_FEATURE_DSP=1, instructions modelled in Stub/main.h), so both are checked to be bit-exact.
+ */
+
+#include "adc_filters.h"
+#include "test.h"
+
+#define TEST_MAX_STRIDE		16U
+#define TEST_MAX_COUNT		67U		// odd, so every stride ends with unpaired tail
+#define TEST_BIG_COUNT		65536U
+
+static uint16_t samples[TEST_BIG_COUNT];
+static const uint16_t offsets[] = {0x0000U, 0x0800U, 0x7FFFU, 0x8000U, 0xFFFFU};	// no offset, 12-bit zero, bias edges, full scale
+static uint32_t seed = 12345U;
+
+static uint16_t Random(void){
+	seed = seed * 1664525U + 1013904223U;
+	return (uint16_t)(seed >> 16);
+}
+
+/* Sample patterns -------------------------------------------------------------------- */
+typedef enum {
+	PATTERN_RANDOM = 0,
+	PATTERN_ZERO,
+	PATTERN_FULL,
+	PATTERN_EXTREMES,	// 0x0000 and 0xFFFF alternating
+	PATTERN_BIAS_EDGE,	// 0x7FFF and 0x8000, which flip sign when biased by 0x80008000
+	PATTERN_12BIT,
+	PATTERN_COUNT
+} PatternTypeDef;
+
+static void Fill(PatternTypeDef pattern, uint32_t length){
+
+	for(uint32_t i = 0; i < length; ++i){
+		uint16_t r = Random();
+
+		switch(pattern){
+			case PATTERN_ZERO:		samples[i] = 0x0000U; break;
+			case PATTERN_FULL:		samples[i] = 0xFFFFU; break;
+			case PATTERN_EXTREMES:	samples[i] = (r & 1U) ? 0xFFFFU : 0x0000U; break;
+			case PATTERN_BIAS_EDGE:	samples[i] = (r & 1U) ? 0x8000U : 0x7FFFU; break;
+			case PATTERN_12BIT:		samples[i] = r & 0x0FFFU; break;
+			default:				samples[i] = r; break;
+		}
+	}
+}
+
+/* Reference -------------------------------------------------------------------------- */
+static void Reference(const uint16_t* s, uint32_t stride, uint32_t count, uint32_t* sum, uint16_t* min, uint16_t* max){
+	*sum = 0;
+
+	for(uint32_t i = 0; i < count; ++i){
+		uint16_t v = s[i * stride];
+
+		*sum += v;
+		*min  = (v < *min) ? v : *min;
+		*max  = (v > *max) ? v : *max;
+	}
+}
+
+static uint64_t ReferenceSquares(const uint16_t* s, uint32_t stride, uint32_t count, uint16_t offset){
+	uint64_t sum = 0;
+
+	for(uint32_t i = 0; i < count; ++i){
+		int64_t deviation = (int64_t)s[i * stride] - offset;
+
+		sum += (uint64_t)(deviation * deviation);
+	}
+
+	return sum;
+}
+
+static void CheckKernels(const uint16_t* s, uint32_t stride, uint32_t count, PatternTypeDef pattern){
+	uint32_t sum;
+	uint16_t min    = 0xFFFFU;
+	uint16_t max    = 0x0000U;
+	uint16_t kmin   = 0xFFFFU;
+	uint16_t kmax   = 0x0000U;
+
+	Reference(s, stride, count, &sum, &min, &max);
+
+	uint32_t ksum  = ADC_Kernel_Sum(s, stride, count);
+	uint32_t kfsum = ADC_Kernel_SumMinMax(s, stride, count, &kmin, &kmax);
+
+	TEST_CHECK(ksum == sum, "sum pattern %d stride %u count %u: %u != %u", pattern, stride, count, ksum, sum);
+	TEST_CHECK(kfsum == sum, "summinmax sum pattern %d stride %u count %u: %u != %u", pattern, stride, count, kfsum, sum);
+	TEST_CHECK(kmin == min && kmax == max, "summinmax pattern %d stride %u count %u: %u..%u != %u..%u", pattern, stride, count, kmin, kmax, min, max);
+
+	for(uint32_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); ++o){
+		uint64_t squares  = ReferenceSquares(s, stride, count, offsets[o]);
+		uint64_t ksquares = ADC_Kernel_SumSquares(s, stride, count, offsets[o]);
+
+		TEST_CHECK(ksquares == squares, "sumsquares pattern %d stride %u count %u offset %u: %llu != %llu", pattern, stride, count, offsets[o],
+				   (unsigned long long)ksquares, (unsigned long long)squares);
+	}
+}
+
+int main(void){
+
+	for(PatternTypeDef pattern = 0; pattern < PATTERN_COUNT; ++pattern){
+		Fill(pattern, TEST_MAX_STRIDE * TEST_MAX_COUNT);
+
+		for(uint32_t stride = 1; stride <= TEST_MAX_STRIDE; ++stride){
+
+			for(uint32_t count = 0; count <= TEST_MAX_COUNT; ++count){
+
+				// every rank of scan, as kernels start at rank offset
+				for(uint32_t rank = 0; rank < stride; ++rank){
+					CheckKernels(&samples[rank], stride, count, pattern);
+				}
+			}
+		}
+	}
+
+	// min and max continue range given by caller
+	uint16_t min = 0x0100U;
+	uint16_t max = 0x0200U;
+	samples[0] = 0x0150U;
+	samples[1] = 0x0180U;
+	(void)ADC_Kernel_SumMinMax(samples, 1, 2, &min, &max);
+	TEST_CHECK(min == 0x0100U && max == 0x0200U, "minmax range not kept: %u..%u", min, max);
+
+	// longest run, full scale sum is 0xFFFF0000 and still fits, sum of squares needs 48 bits
+	Fill(PATTERN_FULL, TEST_BIG_COUNT);
+	CheckKernels(samples, 1, TEST_BIG_COUNT, PATTERN_FULL);
+	Fill(PATTERN_RANDOM, TEST_BIG_COUNT);
+	CheckKernels(samples, 1, TEST_BIG_COUNT, PATTERN_RANDOM);
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	return TEST_RESULT("test_kernels (DSP)");
+#else
+	return TEST_RESULT("test_kernels (C)");
+#endif
+}
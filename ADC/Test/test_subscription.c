@@ -0,0 +1,84 @@
+/*
+ * test_subscription.c
+ *
+ *  Checks reading of unsubscribed channels (ADC_SetSubscription divider 0). Housekeeping ADC with all channels
+ *  unsubscribed must become ready after first completed block and return average of newest samples.
+ *  F1 in independent DMA mode, two ranks (channels 5 and 17), DMA callbacks are called by test.
+ */
+
+#include "adc_driver.h"
+#include "test.h"
+
+#define TEST_RANKS		2U
+
+static ADC_HandleTypeDef   hadc;
+static DMA_Channel_TypeDef dma;
+static DMA_HandleTypeDef   hdma = {&dma};
+static ADC_ContextTypeDef  ctx;
+static ADC_BufferTypeDef   buffer;
+
+static void Setup(void){
+	hadc.Instance   = ADC1;
+	hadc.DMA_Handle = &hdma;
+	ADC1->SQR1      = (TEST_RANKS - 1U) << ADC_SQR1_L_Pos;
+	ADC1->SQR3      = 5U | (17U << 5);
+	ADC1->CR2       = (1U << ADC_CR2_DMA_Pos) | ADC_CR2_CONT;	// DMA enabled, continuous
+	ADC1->SR        = 1U << ADC_SR_STRT_Pos;					// conversion started
+	dma.CCR         = 1U << 5;									// circular DMA
+}
+
+/* Fills half of DMA buffer with rank-dependent ramp and completes it */
+static void CompleteHalf(uint8_t half, uint16_t base){
+	uint16_t* samples = &buffer.idma.BufferADC[half * ADC_DMA_HALF_SCANS * TEST_RANKS];
+
+	for(uint32_t scan = 0; scan < ADC_DMA_HALF_SCANS; ++scan){
+		samples[scan * TEST_RANKS]      = (uint16_t)(base + scan);
+		samples[scan * TEST_RANKS + 1U] = (uint16_t)(2U * base + scan);
+	}
+
+	if(half == 0){
+		HAL_ADC_ConvHalfCpltCallback(&hadc);
+	}else{
+		HAL_ADC_ConvCpltCallback(&hadc);
+	}
+}
+
+int main(void){
+	uint16_t value;
+	uint16_t values[TEST_RANKS];
+	uint16_t expected = (uint16_t)(100U + (ADC_DMA_HALF_SCANS - 1U) / 2U);	// average of ramp 100 .. 100 + scans - 1
+
+	Setup();
+
+	TEST_CHECK(ADC_Init(&ctx, &hadc, &buffer) == HAL_OK, "init failed");
+	TEST_CHECK(ctx.config.mode == ADC_MODE_INDEPENDENT && ctx.config.convertedChannels == TEST_RANKS, "unexpected snapshot");
+	TEST_CHECK(ADC_SetSubscription(&ctx, 5, 0) == ADC_OK && ADC_SetSubscription(&ctx, 17, 0) == ADC_OK, "subscription rejected");
+
+	// nothing completed yet
+	TEST_CHECK(ADC_Averaging(&ctx, 5, &value) == ADC_Busy, "lazy channel ready before first block");
+	TEST_CHECK(ADC_ReadAllChannels(&ctx, values, NULL, 1.0f, TEST_RANKS) == ADC_Busy, "all channels ready before first block");
+
+	// one completed block is enough for lazy ranks
+	CompleteHalf(0, 100U);
+
+	TEST_CHECK(ADC_Averaging(&ctx, 5, &value) == ADC_OK, "lazy channel busy after first block, filled %u", ctx.aadc.filled);
+	TEST_CHECK(value == expected, "channel 5: %u != %u", value, expected);
+	TEST_CHECK(ADC_ReadChannel(&ctx, 17, &value) == ADC_OK && value == 100U + expected, "channel 17: %u != %u", value, 100U + expected);
+	TEST_CHECK(ADC_ReadAllChannels(&ctx, values, NULL, 1.0f, TEST_RANKS) == ADC_OK, "all channels busy, filled %u", ctx.aadc.filled);
+	TEST_CHECK(values[0] == expected && values[1] == 100U + expected, "all channels: %u %u", values[0], values[1]);
+
+	// many cycles later lazy ranks follow newest block
+	for(uint16_t cycle = 0; cycle < 10U; ++cycle){
+		CompleteHalf(1, 200U + cycle);
+		CompleteHalf(0, 300U + cycle);
+	}
+
+	TEST_CHECK(ADC_Averaging(&ctx, 5, &value) == ADC_OK && value == expected + 209U, "channel 5 after cycles: %u", value);
+
+	// restart invalidates lazy ranks until next block
+	TEST_CHECK(ADC_Reconfigure(&ctx) == HAL_OK, "reconfigure failed");
+	TEST_CHECK(ADC_SetSubscription(&ctx, 5, 0) == ADC_OK, "subscription rejected");
+	TEST_CHECK(ADC_Averaging(&ctx, 5, &value) == ADC_Busy, "lazy channel ready after restart");
+
+	return TEST_RESULT("test_subscription");
+}